@@ -0,0 +1,106 @@
+#include "batch.h"
+
+// Asegura sitio para 'vertices' vértices e 'indices' índices más. El lote crece
+// al doble cuando se llena; si no hay memoria la primitiva se descarta.
+static bool reserve(VectorBatch* batch, int vertices, int indices) {
+    if (batch->vertex_count + vertices > batch->vertex_capacity) {
+        int capacity = SDL_max(SDL_max(batch->vertex_capacity * 2, VECTOR_BATCH_INITIAL_VERTICES), batch->vertex_count + vertices);
+        SDL_Vertex* grown = SDL_realloc(batch->vertices, sizeof(SDL_Vertex) * capacity);
+        if (!grown) {
+            return false;
+        }
+        batch->vertices = grown;
+        batch->vertex_capacity = capacity;
+    }
+    if (batch->index_count + indices > batch->index_capacity) {
+        int capacity = SDL_max(SDL_max(batch->index_capacity * 2, VECTOR_BATCH_INITIAL_VERTICES * 3 / 2), batch->index_count + indices);
+        int* grown = SDL_realloc(batch->indices, sizeof(int) * capacity);
+        if (!grown) {
+            return false;
+        }
+        batch->indices = grown;
+        batch->index_capacity = capacity;
+    }
+    return true;
+}
+
+SDL_Vertex* batch_quads(VectorBatch* batch, int count) {
+    if (!reserve(batch, 4 * count, 6 * count)) {
+        return NULL;
+    }
+    int base = batch->vertex_count;
+    int* idx = &batch->indices[batch->index_count];
+    for (int q = 0; q < count; q++, base += 4, idx += 6) {
+        idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+        idx[3] = base; idx[4] = base + 2; idx[5] = base + 3;
+    }
+    SDL_Vertex* v = &batch->vertices[batch->vertex_count];
+    batch->vertex_count += 4 * count;
+    batch->index_count += 6 * count;
+    return v;
+}
+
+void batch_line(VectorBatch* batch, float x0, float y0, float x1, float y1, SDL_FColor color) {
+    SDL_Vertex* v = batch_quads(batch, 1);
+    if (!v) {
+        return;
+    }
+
+    // (ux, uy): medio grosor en la dirección del segmento. Cada extremo se alarga
+    // medio grosor para que las esquinas de las polilíneas queden cerradas.
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float length = SDL_sqrtf(dx * dx + dy * dy);
+    float half = VECTOR_LINE_WIDTH * 0.5f;
+    float ux = length > 0.0f ? dx / length * half : half; // Segmento nulo: un punto
+    float uy = length > 0.0f ? dy / length * half : 0.0f;
+    x0 -= ux; y0 -= uy;
+    x1 += ux; y1 += uy;
+
+    v[0] = (SDL_Vertex){ {x0 - uy, y0 + ux}, color, {0.0f, 0.0f} };
+    v[1] = (SDL_Vertex){ {x0 + uy, y0 - ux}, color, {0.0f, 0.0f} };
+    v[2] = (SDL_Vertex){ {x1 + uy, y1 - ux}, color, {0.0f, 0.0f} };
+    v[3] = (SDL_Vertex){ {x1 - uy, y1 + ux}, color, {0.0f, 0.0f} };
+}
+
+void batch_polyline(VectorBatch* batch, const SDL_FPoint* points, int count, SDL_FColor color) {
+    for (int i = 0; i + 1 < count; i++) {
+        batch_line(batch, points[i].x, points[i].y, points[i + 1].x, points[i + 1].y, color);
+    }
+}
+
+void batch_triangle(VectorBatch* batch, SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_FColor color) {
+    if (!reserve(batch, 3, 3)) {
+        return;
+    }
+    int base = batch->vertex_count;
+    SDL_Vertex* v = &batch->vertices[base];
+    v[0] = (SDL_Vertex){ a, color, {0.0f, 0.0f} };
+    v[1] = (SDL_Vertex){ b, color, {0.0f, 0.0f} };
+    v[2] = (SDL_Vertex){ c, color, {0.0f, 0.0f} };
+
+    int* idx = &batch->indices[batch->index_count];
+    idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+    batch->vertex_count += 3;
+    batch->index_count += 3;
+}
+
+void batch_fill_rect(VectorBatch* batch, const SDL_FRect* rect, SDL_FColor color) {
+    SDL_Vertex* v = batch_quads(batch, 1);
+    if (!v) {
+        return;
+    }
+    float x0 = rect->x, y0 = rect->y;
+    float x1 = rect->x + rect->w, y1 = rect->y + rect->h;
+
+    v[0] = (SDL_Vertex){ {x0, y0}, color, {0.0f, 0.0f} };
+    v[1] = (SDL_Vertex){ {x1, y0}, color, {0.0f, 0.0f} };
+    v[2] = (SDL_Vertex){ {x1, y1}, color, {0.0f, 0.0f} };
+    v[3] = (SDL_Vertex){ {x0, y1}, color, {0.0f, 0.0f} };
+}
+
+void destroy_vector_batch(VectorBatch* batch) {
+    SDL_free(batch->vertices);
+    SDL_free(batch->indices);
+    *batch = (VectorBatch){0};
+}
@@ -0,0 +1,27 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "game.h"
+
+// --- Lote de Primitivas Vectoriales ---
+// Las entidades no dibujan directamente: añaden sus segmentos y triángulos al
+// lote de la lista de dibujo del fotograma (game->frame.vectors, ver
+// render.h), que los envía con un solo SDL_RenderGeometry por tramo. Los
+// segmentos se dibujan como quads de VECTOR_LINE_WIDTH de grosor y el color
+// va en cada vértice, así que no hace falta cambiar el color del renderizador
+// entre entidades. El renderizador está en SDL_BLENDMODE_BLEND, así que el
+// alpha de cada vértice también cuenta.
+
+void batch_line(VectorBatch* batch, float x0, float y0, float x1, float y1, SDL_FColor color);
+// Une points[0], points[1], ..., points[count - 1]; para cerrarla, repetir el primero al final
+void batch_polyline(VectorBatch* batch, const SDL_FPoint* points, int count, SDL_FColor color);
+void batch_triangle(VectorBatch* batch, SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_FColor color);
+void batch_fill_rect(VectorBatch* batch, const SDL_FRect* rect, SDL_FColor color);
+// Reserva 'count' quads con los índices ya escritos y devuelve sus 4 * count
+// vértices para que el llamador los rellene (por quad: arriba-izquierda,
+// arriba-derecha, abajo-derecha, abajo-izquierda). NULL si no hay memoria.
+SDL_Vertex* batch_quads(VectorBatch* batch, int count);
+
+void destroy_vector_batch(VectorBatch* batch);
+
+#endif // BATCH_H
@@ -0,0 +1,314 @@
+#include "game.h"
+#include "entities.h"
+#include "kinematics.h"
+#include "rng.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// --- Benchmark del pipeline de actualización de entidades ---
+// Mide ns/entidad de cada sistema con 10..1M entidades. Para cada tamaño se
+// crea una partida con la pool del sistema medido dimensionada a su medida.
+
+#define BENCH_DT 0.0001f // dt pequeño: nada caduca mientras se mide
+#define BENCH_MIN_ENTITIES_PER_SAMPLE 20000
+#define BENCH_DEFAULT_THRESHOLD 10.0 // % de empeoramiento que cuenta como regresión
+#define BENCH_SEED 12345
+
+typedef struct {
+    const char* name;
+    bool mutates;                      // Restaurar el estado antes de cada llamada
+    void (*size)(PoolCapacities* capacities, int count); // Capacidad para 'count' entidades
+    void (*populate)(Game* game, int count);
+    void (*run)(Game* game, int count);
+} BenchCase;
+
+typedef struct {
+    const char* name;
+    int entities;
+    double median_ns;
+    double p99_ns;
+    double entities_per_sec;
+} BenchResult;
+
+static const int bench_counts[] = { 10, 100, 1000, 10000, 100000, 1000000 };
+#define BENCH_COUNT_STEPS (int)(sizeof(bench_counts) / sizeof(bench_counts[0]))
+
+// Generador propio para poblar los casos; cada caso parte de la misma semilla
+static Rng bench_rng;
+
+static float frand(float lo, float hi) {
+    return lo + rng_float(&bench_rng) * (hi - lo);
+}
+
+static void prepare_game(Game* game) {
+    start_new_game(game);
+    game->respawn_timer = 1000.0f; // Nave invulnerable: check_collisions no termina la partida
+    game->ship.vel = (SDL_FPoint){ 30.0f, -20.0f };
+    game->ufo.spawn_timer = 1e9f;
+}
+
+// --- Casos ---
+
+static void populate_bullets(Game* game, int count) {
+    for (int i = 0; i < count; i++) {
+        game->ship.angle = frand(0.0f, 360.0f);
+        fire_bullet(game);
+    }
+    game->ship.angle = -90.0f;
+}
+
+static void populate_asteroids(Game* game, int count) {
+    for (int i = 0; i < count; i++) {
+        create_asteroid(game, frand(0.0f, SCREEN_WIDTH), frand(0.0f, SCREEN_HEIGHT), 1 + rng_int(&bench_rng, 3), NULL, NULL);
+    }
+}
+
+static void populate_particles(Game* game, int count) {
+    spawn_explosion(game, frand(0.0f, SCREEN_WIDTH), frand(0.0f, SCREEN_HEIGHT), (SDL_FColor){1.0f, 1.0f, 1.0f, 1.0f}, count);
+}
+
+static void populate_stars(Game* game, int count) {
+    (void)count; // Las estrellas llenan siempre la pool, que ya mide 'count'
+    init_stars(game);
+}
+
+// Asteroides en la mitad izquierda y balas en la derecha, con una celda de la
+// rejilla entre medias: con miles de entidades el campo se satura y el coste de
+// los impactos (explosiones, fragmentos) taparía el de la detección, que es lo
+// que se quiere medir
+static void populate_collisions(Game* game, int count) {
+    for (int i = 0; i < (count + 1) / 2; i++) {
+        float x = frand(0.0f, SCREEN_WIDTH / 2.0f - ASTEROID_MAX_RADIUS);
+        create_asteroid(game, x, frand(0.0f, SCREEN_HEIGHT), 1 + rng_int(&bench_rng, 3), NULL, NULL);
+    }
+    populate_bullets(game, count / 2);
+    BulletPool* bullets = &game->bullets;
+    for (int i = 0; i < bullets->count; i++) {
+        bullets->pos_x[i] = frand(SCREEN_WIDTH / 2.0f + GRID_CELL_SIZE, SCREEN_WIDTH);
+        bullets->pos_y[i] = frand(0.0f, SCREEN_HEIGHT);
+    }
+}
+
+static void populate_nothing(Game* game, int count) {
+    (void)game;
+    (void)count;
+}
+
+static void size_bullets(PoolCapacities* capacities, int count) { capacities->bullets = count; }
+static void size_asteroids(PoolCapacities* capacities, int count) { capacities->asteroids = count; }
+static void size_particles(PoolCapacities* capacities, int count) { capacities->particles = count; }
+static void size_stars(PoolCapacities* capacities, int count) { capacities->stars = count; }
+static void size_collisions(PoolCapacities* capacities, int count) {
+    capacities->asteroids = (count + 1) / 2;
+    capacities->bullets = count / 2 > 0 ? count / 2 : 1;
+}
+
+static void run_update_bullets(Game* game, int count) { (void)count; update_bullets(game, BENCH_DT); }
+static void run_update_asteroids(Game* game, int count) { (void)count; update_asteroids(game, BENCH_DT); }
+static void run_update_particles(Game* game, int count) { (void)count; update_particles(game, BENCH_DT); }
+static void run_update_stars(Game* game, int count) { (void)count; update_stars(game, BENCH_DT); }
+static void run_check_collisions(Game* game, int count) { (void)count; check_collisions(game); }
+static void run_spawn_explosion(Game* game, int count) {
+    spawn_explosion(game, SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f, (SDL_FColor){1.0f, 1.0f, 1.0f, 1.0f}, count);
+}
+
+static const BenchCase bench_cases[] = {
+    { "update_bullets",   false, size_bullets,    populate_bullets,    run_update_bullets },
+    { "update_asteroids", false, size_asteroids,  populate_asteroids,  run_update_asteroids },
+    { "update_particles", false, size_particles,  populate_particles,  run_update_particles },
+    { "update_stars",     false, size_stars,      populate_stars,      run_update_stars },
+    { "check_collisions", true,  size_collisions, populate_collisions, run_check_collisions },
+    { "spawn_explosion",  true,  size_particles,  populate_nothing,    run_spawn_explosion },
+};
+#define BENCH_CASE_COUNT (int)(sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+// --- Medición ---
+
+static int compare_double(const void* a, const void* b) {
+    double da = *(const double*)a, db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+static double elapsed_ns(Uint64 start, Uint64 end) {
+    return (double)(end - start) * 1e9 / (double)SDL_GetPerformanceFrequency();
+}
+
+// Devuelve false si no hay memoria para las pools
+static bool run_case(const BenchCase* bc, int entities, BenchResult* result) {
+    PoolCapacities capacities = {
+        DEFAULT_MAX_BULLETS, DEFAULT_MAX_ASTEROIDS, DEFAULT_MAX_POWERUPS, DEFAULT_MAX_STARS, DEFAULT_MAX_PARTICLES
+    };
+    bc->size(&capacities, entities);
+
+    // 'pristine' guarda el estado recién poblado; 'game' es el que se mide
+    Game* game = calloc(1, sizeof(Game));
+    Game* pristine = calloc(1, sizeof(Game));
+    if (!game || !pristine || !init_entity_pools(game, &capacities) || !init_entity_pools(pristine, &capacities)) {
+        if (game) free_entity_pools(game);
+        if (pristine) free_entity_pools(pristine);
+        free(game);
+        free(pristine);
+        return false;
+    }
+
+    rng_seed(&bench_rng, BENCH_SEED, 0);
+    seed_game_rngs(pristine, BENCH_SEED);
+    seed_game_rngs(game, BENCH_SEED);
+    prepare_game(pristine);
+    bc->populate(pristine, entities);
+    prepare_game(game);
+    copy_entity_pools(game, pristine);
+
+    // Repeticiones por muestra para superar la resolución del temporizador
+    int reps = 1;
+    if (!bc->mutates && entities < BENCH_MIN_ENTITIES_PER_SAMPLE) {
+        reps = BENCH_MIN_ENTITIES_PER_SAMPLE / entities;
+    }
+    int samples = entities >= 100000 ? 21 : 101;
+    double* ns_per_entity = malloc(sizeof(double) * samples);
+
+    for (int k = 0; k < samples; k++) {
+        double ns = 0.0;
+        if (bc->mutates) {
+            copy_entity_pools(game, pristine);
+            Uint64 start = SDL_GetPerformanceCounter();
+            bc->run(game, entities);
+            ns = elapsed_ns(start, SDL_GetPerformanceCounter());
+        } else {
+            Uint64 start = SDL_GetPerformanceCounter();
+            for (int r = 0; r < reps; r++) {
+                bc->run(game, entities);
+            }
+            ns = elapsed_ns(start, SDL_GetPerformanceCounter());
+        }
+        ns_per_entity[k] = ns / ((double)entities * reps);
+    }
+
+    qsort(ns_per_entity, samples, sizeof(double), compare_double);
+    result->name = bc->name;
+    result->entities = entities;
+    result->median_ns = ns_per_entity[samples / 2];
+    result->p99_ns = ns_per_entity[(samples * 99) / 100];
+    result->entities_per_sec = result->median_ns > 0.0 ? 1e9 / result->median_ns : 0.0;
+    free(ns_per_entity);
+    free_entity_pools(game);
+    free_entity_pools(pristine);
+    free(game);
+    free(pristine);
+    return true;
+}
+
+// --- Línea base ---
+
+static bool write_csv(const char* path, const BenchResult* results, int count) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "No se pudo escribir %s\n", path);
+        return false;
+    }
+    fprintf(file, "case,entities,median_ns,p99_ns,entities_per_sec\n");
+    for (int i = 0; i < count; i++) {
+        fprintf(file, "%s,%d,%.4f,%.4f,%.0f\n", results[i].name, results[i].entities,
+                results[i].median_ns, results[i].p99_ns, results[i].entities_per_sec);
+    }
+    fclose(file);
+    return true;
+}
+
+// Devuelve el número de regresiones frente a la línea base, o -1 si no se pudo leer
+static int compare_baseline(const char* path, const BenchResult* results, int count, double threshold) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "No se pudo leer la línea base %s\n", path);
+        return -1;
+    }
+
+    int regressions = 0;
+    char line[256];
+    printf("\nComparación con %s (umbral %.1f%%)\n", path, threshold);
+    printf("%-18s %10s %12s %12s %9s\n", "caso", "entidades", "base ns", "actual ns", "cambio");
+    while (fgets(line, sizeof(line), file)) {
+        char name[64];
+        int entities;
+        double median, p99, eps;
+        if (sscanf(line, "%63[^,],%d,%lf,%lf,%lf", name, &entities, &median, &p99, &eps) != 5) {
+            continue; // Cabecera o línea vacía
+        }
+        for (int i = 0; i < count; i++) {
+            if (results[i].entities == entities && SDL_strcmp(results[i].name, name) == 0) {
+                double change = median > 0.0 ? (results[i].median_ns - median) / median * 100.0 : 0.0;
+                bool regressed = change > threshold;
+                regressions += regressed ? 1 : 0;
+                printf("%-18s %10d %12.3f %12.3f %+8.1f%%%s\n", name, entities, median,
+                       results[i].median_ns, change, regressed ? "  REGRESIÓN" : "");
+            }
+        }
+    }
+    fclose(file);
+    return regressions;
+}
+
+// --- Principal ---
+
+int main(int argc, char* argv[]) {
+    const char* csv_path = NULL;
+    const char* baseline_path = NULL;
+    const char* only = NULL;
+    const char* kernel = NULL;
+    double threshold = BENCH_DEFAULT_THRESHOLD;
+    int max_entities = bench_counts[BENCH_COUNT_STEPS - 1];
+
+    for (int i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--compare") == 0 && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = SDL_atof(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--case") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--max-entities") == 0 && i + 1 < argc) {
+            max_entities = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+            kernel = argv[++i];
+        } else {
+            fprintf(stderr, "Uso: %s [--csv FICHERO] [--compare LINEA_BASE] [--threshold PCT] [--case NOMBRE] [--max-entities N] [--kernel avx2|sse2|scalar]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (!init_kinematics(kernel)) {
+        return 2;
+    }
+    printf("Núcleo cinemático: %s\n", kinematics->name);
+
+    BenchResult results[BENCH_CASE_COUNT * BENCH_COUNT_STEPS];
+    int result_count = 0;
+
+    printf("%-18s %10s %12s %12s %14s\n", "caso", "entidades", "mediana ns", "p99 ns", "entidades/s");
+    for (int c = 0; c < BENCH_CASE_COUNT; c++) {
+        if (only && SDL_strcmp(only, bench_cases[c].name) != 0) continue;
+        for (int n = 0; n < BENCH_COUNT_STEPS; n++) {
+            if (bench_counts[n] > max_entities) break;
+            BenchResult r;
+            if (!run_case(&bench_cases[c], bench_counts[n], &r)) {
+                fprintf(stderr, "Sin memoria para %d entidades en %s\n", bench_counts[n], bench_cases[c].name);
+                return 1;
+            }
+            results[result_count++] = r;
+            printf("%-18s %10d %12.3f %12.3f %14.0f\n", r.name, r.entities, r.median_ns, r.p99_ns, r.entities_per_sec);
+            fflush(stdout);
+        }
+    }
+
+    if (csv_path && !write_csv(csv_path, results, result_count)) {
+        return 1;
+    }
+    if (baseline_path) {
+        int regressions = compare_baseline(baseline_path, results, result_count, threshold);
+        if (regressions != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
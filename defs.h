@@ -8,23 +8,92 @@
 #define SHIP_ACCELERATION 200.0f
 #define SHIP_TURN_SPEED 200.0f
 #define SHIP_FRICTION 0.5f
-#define MAX_BULLETS 10
 #define BULLET_SPEED 400.0f
 #define BULLET_LIFESPAN 1.5f
-#define MAX_ASTEROIDS 10
 #define ASTEROID_SPEED 50.0f
 #define ASTEROID_MAX_VERTS 12
 #define UFO_SPEED 100.0f
 #define UFO_SPAWN_TIME 15.0f
-#define MAX_POWERUPS 5
 #define POWERUP_LIFESPAN 8.0f
 #define POWERUP_SIZE 10.0f
 #define SHIELD_DURATION 10.0f
+#define SHIELD_SEGMENTS 24
 #define TRIPLE_SHOT_DURATION 10.0f
-#define MAX_STARS 200
-#define MAX_PARTICLES 200
 #define PARTICLE_LIFESPAN 1.0f
 #define HYPERSPACE_DURATION 0.5f
 #define HYPERSPACE_COOLDOWN 5.0f
+#define ASTEROID_MAX_RADIUS 30.0f // Tamaño 3 * 10
+#define STAR_LAYERS 3 // Capas de paralaje; init_stars las agrupa con una partición en tres
+#define WORLD_RECENTER_DISTANCE 16384.0f // Si la nave se aleja tanto del centro, todo se recoloca (precisión)
+
+// --- Capacidad de las Pools ---
+// Valores por defecto; se cambian al arrancar con --max-bullets, --max-asteroids, ...
+#define DEFAULT_MAX_BULLETS 10
+#define DEFAULT_MAX_ASTEROIDS 10
+#define DEFAULT_MAX_POWERUPS 5
+#define DEFAULT_MAX_STARS 200
+#define DEFAULT_MAX_PARTICLES 200
+#define POOL_CAPACITY_LIMIT (1 << 22) // Máximo admitido para cualquier pool
+#define POOL_ALIGNMENT 64             // Cada array del arena empieza en una línea de caché
+
+// --- Colisiones ---
+// Rejilla uniforme que cubre la vista más un margen para lo que hace wrap
+#define GRID_CELL_SIZE 64
+#define GRID_MARGIN 64
+#define GRID_COLS ((SCREEN_WIDTH + 2 * GRID_MARGIN + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE)
+#define GRID_ROWS ((SCREEN_HEIGHT + 2 * GRID_MARGIN + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE)
+#define GRID_CELLS (GRID_COLS * GRID_ROWS)
+
+// --- Bucle Principal ---
+#define SIM_TICK_RATE 120          // Pasos de simulación por segundo (modo de paso fijo)
+#define MAX_FRAME_TIME 0.25f       // Tiempo máximo que se recupera tras un tirón
+#define MAX_VARIABLE_DT 0.05f      // Límite del dt en el modo de paso variable
+#define INTERP_SNAP_DISTANCE 64.0f // Saltos mayores (wrap, hiperespacio) no se interpolan
+
+// --- Hilos de la Simulación ---
+#define JOB_MAX_THREADS 32   // Incluido el principal
+#define JOB_QUEUE_SIZE 256   // Tareas en cola por hilo; si no caben, se ejecutan al momento
+#define JOB_CHUNK_SIZE 16384 // Entidades por tramo; las pools más pequeñas no se reparten
+#define PIPELINE_INPUT_EVENTS 64 // Pulsaciones en espera para el hilo de la simulación (--pipeline)
+
+// --- Modo Headless ---
+#define HEADLESS_DEFAULT_GAMES 100
+#define HEADLESS_DEFAULT_MAX_TICKS (SIM_TICK_RATE * 60 * 10) // 10 minutos de juego
+
+// --- Dibujo Vectorial ---
+#define VECTOR_LINE_WIDTH 1.5f              // Grosor de los segmentos del lote vectorial
+#define VECTOR_BATCH_INITIAL_VERTICES 1024
+#define RENDER_LIST_INITIAL_COMMANDS 64
+#define RENDER_LIST_INITIAL_ITEMS 256  // Puntos o rectángulos de las estrellas
+#define RENDER_LIST_INITIAL_TEXT 1024  // Bytes de las cadenas de texto
+#define RENDER_DUMP_FILE "frame.txt"   // Volcado del último fotograma con F5
+
+// --- Récords ---
+#define LEADERBOARD_SIZE 10
+#define LEADERBOARD_FILE "leaderboard.dat"
+#define LEADERBOARD_LEGACY_FILE "highscore.txt" // Formato anterior; se importa si no hay LEADERBOARD_FILE
+#define LEADERBOARD_NAME_SIZE 24   // Incluido el '\0'
+#define LEADERBOARD_REPLAY_SIZE 48 // Incluido el '\0'
+#define LEADERBOARD_MENU_ROWS 5    // Entradas que se ven en el menú
+#define DEFAULT_PLAYER_NAME "JUGADOR"
+
+// --- Perfilado (make PROFILE=1) ---
+#define PROFILE_HISTORY_FRAMES 240       // Fotogramas de los que salen min/media/p99
+#define PROFILE_REFRESH_FRAMES 30        // Cada cuántos fotogramas se recalcula la tabla
+#define PROFILE_BUDGET_MS (1000.0f / 60) // Línea de referencia de la gráfica
+#define PROFILE_GRAPH_MS 33.3f           // Altura de la gráfica en ms
+#define PROFILE_REPORT_FILE "profile.csv"
+#define PROFILE_TRACE_EVENTS 65536       // Búfer circular de la traza: unos 20 s de juego a 60 fps
+#define PROFILE_TRACE_FILE "trace.json"  // Volcado con F4 si no se dio --trace
+
+// --- Texto ---
+#define FONT_SIZE 20
+#define TEXT_FIRST_CHAR 32  // ' '
+#define TEXT_LAST_CHAR 126  // '~'
+#define TEXT_GLYPH_COUNT (TEXT_LAST_CHAR - TEXT_FIRST_CHAR + 1)
+#define TEXT_ATLAS_COLUMNS 16
+#define TEXT_MAX_GLYPHS_PER_BATCH 64
+#define TEXT_CACHE_SIZE 12
+#define TEXT_CACHE_MAX_LEN 32
 
 #endif // DEFS_H
\ No newline at end of file
@@ -1,17 +1,474 @@
 #include "entities.h"
+#include "batch.h"
+#include "grid.h"
+#include "kinematics.h"
+#include "render.h"
+#include "rng.h"
+#include "profiler.h"
 #include <math.h>
-#include <stdlib.h>
+#include <string.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+// --- Tablas de Contornos ---
+// Los contornos se guardan sin rotar; para dibujarlos basta un par seno/coseno
+// por entidad y fotograma en lugar de uno por vértice.
+
+static SDL_FPoint asteroid_directions[ASTEROID_MAX_VERTS]; // Vértice j a j * 2π / ASTEROID_MAX_VERTS
+static SDL_FPoint shield_ring[SHIELD_SEGMENTS + 1];          // Círculo unidad cerrado
+static SDL_FPoint ship_hull[5];                              // Nave mirando a +x, cerrada
+static SDL_FPoint flame_directions[3];                       // Punta y base de la llama
+
+static SDL_FPoint unit_direction(float angle) {
+    return (SDL_FPoint){ cosf(angle), sinf(angle) };
+}
+
+static void init_outline_tables(void) {
+    for (int j = 0; j < ASTEROID_MAX_VERTS; j++) {
+        asteroid_directions[j] = unit_direction((float)j / ASTEROID_MAX_VERTS * 2.0f * M_PI);
+    }
+    for (int j = 0; j <= SHIELD_SEGMENTS; j++) {
+        shield_ring[j] = unit_direction((float)j / SHIELD_SEGMENTS * 2.0f * M_PI);
+    }
+
+    SDL_FPoint side = unit_direction(2.4f);
+    ship_hull[0] = (SDL_FPoint){ SHIP_SIZE, 0.0f };
+    ship_hull[1] = (SDL_FPoint){ side.x * SHIP_SIZE, side.y * SHIP_SIZE };
+    ship_hull[2] = (SDL_FPoint){ -SHIP_SIZE * 0.5f, 0.0f };
+    ship_hull[3] = (SDL_FPoint){ side.x * SHIP_SIZE, -side.y * SHIP_SIZE };
+    ship_hull[4] = ship_hull[0];
+
+    flame_directions[0] = (SDL_FPoint){ -1.0f, 0.0f };
+    flame_directions[1] = unit_direction(-M_PI + 0.5f);
+    flame_directions[2] = unit_direction(-M_PI - 0.5f);
+}
+
+// Punto local p escalado por 'scale', girado (coseno c, seno s) y llevado a 'center'
+static SDL_FPoint place_point(SDL_FPoint center, SDL_FPoint p, float scale, float c, float s) {
+    return (SDL_FPoint){ center.x + (p.x * c - p.y * s) * scale, center.y + (p.x * s + p.y * c) * scale };
+}
+
+// --- Pools ---
+
+// Las entidades vivas ocupan [0, count). Crear una es tomar el índice 'count';
+// eliminar la i-ésima es mover la última a su hueco. Los bucles que eliminan
+// mientras recorren van de atrás hacia delante: así la entidad que se mueve al
+// hueco 'i' es una que ya se procesó y sigue viva, y su marca 'expired' es 0.
+
+// Devuelve el índice del nuevo hueco, o -1 (y lo cuenta en 'dropped') si la pool está llena
+static int claim_slot(int* count, int capacity, Uint64* dropped) {
+    if (*count >= capacity) {
+        (*dropped)++;
+        return -1;
+    }
+    return (*count)++;
+}
+
+// Reserva 'count' elementos de 'size' bytes a partir de 'offset'. Con base NULL
+// sólo avanza el desplazamiento: la misma pasada sirve para medir y para repartir.
+static void* carve(Uint8* base, size_t* offset, int count, size_t size) {
+    void* block = base ? base + *offset : NULL;
+    *offset += ((size_t)count * size + POOL_ALIGNMENT - 1) & ~(size_t)(POOL_ALIGNMENT - 1);
+    return block;
+}
+
+static void layout_bullet_pool(BulletPool* bullets, Uint8* base, size_t* offset) {
+    int n = bullets->capacity;
+    bullets->pos_x = carve(base, offset, n, sizeof(float));
+    bullets->pos_y = carve(base, offset, n, sizeof(float));
+    bullets->prev_x = carve(base, offset, n, sizeof(float));
+    bullets->prev_y = carve(base, offset, n, sizeof(float));
+    bullets->vel_x = carve(base, offset, n, sizeof(float));
+    bullets->vel_y = carve(base, offset, n, sizeof(float));
+    bullets->lifetime = carve(base, offset, n, sizeof(float));
+    bullets->expired = carve(base, offset, n, sizeof(Uint8));
+}
+
+// Asigna a cada array de las pools su trozo del arena y devuelve el tamaño total
+static size_t layout_entity_pools(Game* game, Uint8* base) {
+    size_t offset = 0;
+    layout_bullet_pool(&game->bullets, base, &offset);
+    layout_bullet_pool(&game->ufo_bullets, base, &offset);
+
+    AsteroidPool* asteroids = &game->asteroids;
+    int n = asteroids->capacity;
+    asteroids->pos_x = carve(base, &offset, n, sizeof(float));
+    asteroids->pos_y = carve(base, &offset, n, sizeof(float));
+    asteroids->prev_x = carve(base, &offset, n, sizeof(float));
+    asteroids->prev_y = carve(base, &offset, n, sizeof(float));
+    asteroids->vel_x = carve(base, &offset, n, sizeof(float));
+    asteroids->vel_y = carve(base, &offset, n, sizeof(float));
+    asteroids->angle = carve(base, &offset, n, sizeof(float));
+    asteroids->prev_angle = carve(base, &offset, n, sizeof(float));
+    asteroids->rotation_speed = carve(base, &offset, n, sizeof(float));
+    asteroids->size = carve(base, &offset, n, sizeof(int));
+    asteroids->outline = carve(base, &offset, n, sizeof(asteroids->outline[0]));
+    asteroids->expired = carve(base, &offset, n, sizeof(Uint8));
+    asteroids->splits = carve(base, &offset, n, sizeof(AsteroidSplit));
+
+    PowerUpPool* powerups = &game->powerups;
+    n = powerups->capacity;
+    powerups->pos_x = carve(base, &offset, n, sizeof(float));
+    powerups->pos_y = carve(base, &offset, n, sizeof(float));
+    powerups->prev_x = carve(base, &offset, n, sizeof(float));
+    powerups->prev_y = carve(base, &offset, n, sizeof(float));
+    powerups->lifetime = carve(base, &offset, n, sizeof(float));
+    powerups->type = carve(base, &offset, n, sizeof(PowerUpType));
+    powerups->expired = carve(base, &offset, n, sizeof(Uint8));
+
+    StarPool* stars = &game->stars;
+    n = stars->capacity;
+    stars->pos_x = carve(base, &offset, n, sizeof(float));
+    stars->pos_y = carve(base, &offset, n, sizeof(float));
+    stars->parallax = carve(base, &offset, n, sizeof(float));
+
+    ParticlePool* particles = &game->particles;
+    n = particles->capacity;
+    particles->pos_x = carve(base, &offset, n, sizeof(float));
+    particles->pos_y = carve(base, &offset, n, sizeof(float));
+    particles->prev_x = carve(base, &offset, n, sizeof(float));
+    particles->prev_y = carve(base, &offset, n, sizeof(float));
+    particles->vel_x = carve(base, &offset, n, sizeof(float));
+    particles->vel_y = carve(base, &offset, n, sizeof(float));
+    particles->lifetime = carve(base, &offset, n, sizeof(float));
+    particles->color = carve(base, &offset, n, sizeof(SDL_FColor));
+    particles->expired = carve(base, &offset, n, sizeof(Uint8));
+
+    // La rejilla indexa asteroides, las dos pools de balas y power-ups
+    game->grid.next = carve(base, &offset, asteroids->capacity + 2 * game->bullets.capacity + powerups->capacity, sizeof(int));
+
+    ContactBuffer* contacts = &game->contacts;
+    contacts->capacity = asteroids->capacity + powerups->capacity + 3;
+    contacts->items = carve(base, &offset, contacts->capacity, sizeof(Contact));
+    contacts->claimed = carve(base, &offset, game->bullets.capacity, sizeof(Uint8));
+    return offset;
+}
+
+static bool valid_capacity(const char* name, int capacity) {
+    if (capacity < 1 || capacity > POOL_CAPACITY_LIMIT) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "La capacidad de %s debe estar entre 1 y %d (es %d)",
+                     name, POOL_CAPACITY_LIMIT, capacity);
+        return false;
+    }
+    return true;
+}
+
+bool init_entity_pools(Game* game, const PoolCapacities* capacities) {
+    // Nada crea asteroides antes de tener las pools: buen momento para las tablas
+    init_outline_tables();
+
+    if (!valid_capacity("balas", capacities->bullets) ||
+        !valid_capacity("asteroides", capacities->asteroids) ||
+        !valid_capacity("power-ups", capacities->powerups) ||
+        !valid_capacity("estrellas", capacities->stars) ||
+        !valid_capacity("partículas", capacities->particles)) {
+        return false;
+    }
+
+    game->bullets.capacity = capacities->bullets;
+    game->ufo_bullets.capacity = capacities->bullets;
+    game->asteroids.capacity = capacities->asteroids;
+    game->powerups.capacity = capacities->powerups;
+    game->stars.capacity = capacities->stars;
+    game->particles.capacity = capacities->particles;
+
+    // Primera pasada para medir, reserva única y segunda pasada para repartir.
+    // A cero, todas las marcas 'expired' empiezan limpias.
+    size_t size = layout_entity_pools(game, NULL);
+    Uint8* arena = SDL_aligned_alloc(POOL_ALIGNMENT, size);
+    if (!arena) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudieron reservar %zu bytes para las pools", size);
+        return false;
+    }
+    SDL_memset(arena, 0, size);
+    layout_entity_pools(game, arena);
+    game->entity_arena = arena;
+    game->entity_arena_size = size;
+    return true;
+}
+
+void free_entity_pools(Game* game) {
+    SDL_aligned_free(game->entity_arena);
+    game->entity_arena = NULL;
+    game->entity_arena_size = 0;
+    clear_entities(game);
+    game->stars.count = 0;
+}
+
+void copy_entity_pools(Game* dst, const Game* src) {
+    // Mismas capacidades, misma disposición: basta copiar el bloque y los contadores
+    SDL_memcpy(dst->entity_arena, src->entity_arena, src->entity_arena_size);
+    dst->bullets.count = src->bullets.count;
+    dst->ufo_bullets.count = src->ufo_bullets.count;
+    dst->asteroids.count = src->asteroids.count;
+    dst->powerups.count = src->powerups.count;
+    dst->stars.count = src->stars.count;
+    dst->stars.step = src->stars.step;
+    SDL_memcpy(dst->stars.offset, src->stars.offset, sizeof(src->stars.offset));
+    SDL_memcpy(dst->stars.layer_start, src->stars.layer_start, sizeof(src->stars.layer_start));
+    dst->particles.count = src->particles.count;
+}
+
+// Copia el tramo vivo de 'count' floats
+static void copy_live(float* dst, const float* src, int count) {
+    SDL_memcpy(dst, src, sizeof(float) * count);
+}
+
+void snapshot_entity_pools(Game* dst, const Game* src) {
+    const BulletPool* bullets = &src->bullets;
+    int n = bullets->count;
+    copy_live(dst->bullets.pos_x, bullets->pos_x, n);
+    copy_live(dst->bullets.pos_y, bullets->pos_y, n);
+    copy_live(dst->bullets.prev_x, bullets->prev_x, n);
+    copy_live(dst->bullets.prev_y, bullets->prev_y, n);
+    copy_live(dst->bullets.vel_x, bullets->vel_x, n);
+    copy_live(dst->bullets.vel_y, bullets->vel_y, n);
+    dst->bullets.count = n;
+
+    const BulletPool* ufo_bullets = &src->ufo_bullets;
+    n = ufo_bullets->count;
+    copy_live(dst->ufo_bullets.pos_x, ufo_bullets->pos_x, n);
+    copy_live(dst->ufo_bullets.pos_y, ufo_bullets->pos_y, n);
+    copy_live(dst->ufo_bullets.prev_x, ufo_bullets->prev_x, n);
+    copy_live(dst->ufo_bullets.prev_y, ufo_bullets->prev_y, n);
+    dst->ufo_bullets.count = n;
+
+    const AsteroidPool* asteroids = &src->asteroids;
+    n = asteroids->count;
+    copy_live(dst->asteroids.pos_x, asteroids->pos_x, n);
+    copy_live(dst->asteroids.pos_y, asteroids->pos_y, n);
+    copy_live(dst->asteroids.prev_x, asteroids->prev_x, n);
+    copy_live(dst->asteroids.prev_y, asteroids->prev_y, n);
+    copy_live(dst->asteroids.angle, asteroids->angle, n);
+    copy_live(dst->asteroids.prev_angle, asteroids->prev_angle, n);
+    SDL_memcpy(dst->asteroids.outline, asteroids->outline, sizeof(asteroids->outline[0]) * n);
+    dst->asteroids.count = n;
+
+    const PowerUpPool* powerups = &src->powerups;
+    n = powerups->count;
+    copy_live(dst->powerups.pos_x, powerups->pos_x, n);
+    copy_live(dst->powerups.pos_y, powerups->pos_y, n);
+    copy_live(dst->powerups.prev_x, powerups->prev_x, n);
+    copy_live(dst->powerups.prev_y, powerups->prev_y, n);
+    copy_live(dst->powerups.lifetime, powerups->lifetime, n);
+    SDL_memcpy(dst->powerups.type, powerups->type, sizeof(PowerUpType) * n);
+    dst->powerups.count = n;
+
+    const ParticlePool* particles = &src->particles;
+    n = particles->count;
+    copy_live(dst->particles.pos_x, particles->pos_x, n);
+    copy_live(dst->particles.pos_y, particles->pos_y, n);
+    copy_live(dst->particles.prev_x, particles->prev_x, n);
+    copy_live(dst->particles.prev_y, particles->prev_y, n);
+    copy_live(dst->particles.lifetime, particles->lifetime, n);
+    SDL_memcpy(dst->particles.color, particles->color, sizeof(SDL_FColor) * n);
+    dst->particles.count = n;
+
+    // Las estrellas no cambian desde init_stars: sólo se mueven las capas
+    dst->stars.step = src->stars.step;
+    SDL_memcpy(dst->stars.offset, src->stars.offset, sizeof(src->stars.offset));
+}
+
+void log_pool_usage(const Game* game) {
+    SDL_Log("Pools: descartados por falta de capacidad: %llu balas (de %d), %llu balas de OVNI, "
+            "%llu asteroides (de %d), %llu power-ups (de %d), %llu partículas (de %d)",
+            (unsigned long long)game->bullets.dropped, game->bullets.capacity,
+            (unsigned long long)game->ufo_bullets.dropped,
+            (unsigned long long)game->asteroids.dropped, game->asteroids.capacity,
+            (unsigned long long)game->powerups.dropped, game->powerups.capacity,
+            (unsigned long long)game->particles.dropped, game->particles.capacity);
+}
+
+static void remove_bullet(BulletPool* bullets, int i) {
+    int last = --bullets->count;
+    bullets->pos_x[i] = bullets->pos_x[last];
+    bullets->pos_y[i] = bullets->pos_y[last];
+    bullets->prev_x[i] = bullets->prev_x[last];
+    bullets->prev_y[i] = bullets->prev_y[last];
+    bullets->vel_x[i] = bullets->vel_x[last];
+    bullets->vel_y[i] = bullets->vel_y[last];
+    bullets->lifetime[i] = bullets->lifetime[last];
+    bullets->expired[i] = 0;
+}
+
+static void remove_asteroid(AsteroidPool* asteroids, int i) {
+    int last = --asteroids->count;
+    asteroids->pos_x[i] = asteroids->pos_x[last];
+    asteroids->pos_y[i] = asteroids->pos_y[last];
+    asteroids->prev_x[i] = asteroids->prev_x[last];
+    asteroids->prev_y[i] = asteroids->prev_y[last];
+    asteroids->vel_x[i] = asteroids->vel_x[last];
+    asteroids->vel_y[i] = asteroids->vel_y[last];
+    asteroids->angle[i] = asteroids->angle[last];
+    asteroids->prev_angle[i] = asteroids->prev_angle[last];
+    asteroids->rotation_speed[i] = asteroids->rotation_speed[last];
+    asteroids->size[i] = asteroids->size[last];
+    memcpy(asteroids->outline[i], asteroids->outline[last], sizeof(asteroids->outline[i]));
+    asteroids->expired[i] = 0;
+}
+
+static void remove_powerup(PowerUpPool* powerups, int i) {
+    int last = --powerups->count;
+    powerups->pos_x[i] = powerups->pos_x[last];
+    powerups->pos_y[i] = powerups->pos_y[last];
+    powerups->prev_x[i] = powerups->prev_x[last];
+    powerups->prev_y[i] = powerups->prev_y[last];
+    powerups->lifetime[i] = powerups->lifetime[last];
+    powerups->type[i] = powerups->type[last];
+    powerups->expired[i] = 0;
+}
+
+static void remove_particle(ParticlePool* particles, int i) {
+    int last = --particles->count;
+    particles->pos_x[i] = particles->pos_x[last];
+    particles->pos_y[i] = particles->pos_y[last];
+    particles->prev_x[i] = particles->prev_x[last];
+    particles->prev_y[i] = particles->prev_y[last];
+    particles->vel_x[i] = particles->vel_x[last];
+    particles->vel_y[i] = particles->vel_y[last];
+    particles->lifetime[i] = particles->lifetime[last];
+    particles->color[i] = particles->color[last];
+    particles->expired[i] = 0;
+}
+
+// Eliminan las entidades marcadas en 'expired' por el núcleo cinemático o por
+// check_collisions. Fuera de estas pasadas la marca vale 0 en todos los huecos.
+void remove_expired_bullets(BulletPool* bullets) {
+    for (int i = bullets->count - 1; i >= 0; i--) {
+        if (bullets->expired[i]) {
+            remove_bullet(bullets, i);
+        }
+    }
+}
+
+static void remove_expired_asteroids(AsteroidPool* asteroids) {
+    for (int i = asteroids->count - 1; i >= 0; i--) {
+        if (asteroids->expired[i]) {
+            remove_asteroid(asteroids, i);
+        }
+    }
+}
+
+static void remove_expired_powerups(PowerUpPool* powerups) {
+    for (int i = powerups->count - 1; i >= 0; i--) {
+        if (powerups->expired[i]) {
+            remove_powerup(powerups, i);
+        }
+    }
+}
+
+void remove_expired_particles(ParticlePool* particles) {
+    for (int i = particles->count - 1; i >= 0; i--) {
+        if (particles->expired[i]) {
+            remove_particle(particles, i);
+        }
+    }
+}
+
+void clear_entities(Game* game) {
+    game->bullets.count = 0;
+    game->ufo_bullets.count = 0;
+    game->asteroids.count = 0;
+    game->powerups.count = 0;
+    game->particles.count = 0;
+}
+
+// --- Interpolación ---
+
+static float lerp_float(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+// Punto del mundo entre el paso anterior y el actual. Si el salto es grande
+// (wrap, hiperespacio) se toma directamente la posición actual.
+static SDL_FPoint interpolate_world(const Game* game, float prev_x, float prev_y, float x, float y) {
+    float dx = x - prev_x;
+    float dy = y - prev_y;
+    if (dx * dx + dy * dy > INTERP_SNAP_DISTANCE * INTERP_SNAP_DISTANCE) {
+        return (SDL_FPoint){ x, y };
+    }
+    return (SDL_FPoint){ prev_x + dx * game->render_alpha, prev_y + dy * game->render_alpha };
+}
+
+// Posición en pantalla a dibujar (ver update_camera)
+static SDL_FPoint interpolate_pos(const Game* game, float prev_x, float prev_y, float x, float y) {
+    SDL_FPoint pos = interpolate_world(game, prev_x, prev_y, x, y);
+    return (SDL_FPoint){ pos.x - game->camera.x, pos.y - game->camera.y };
+}
+
+void update_camera(Game* game) {
+    SDL_FPoint ship = interpolate_world(game, game->ship.prev_pos.x, game->ship.prev_pos.y, game->ship.pos.x, game->ship.pos.y);
+    game->camera = (SDL_FPoint){ ship.x - SCREEN_WIDTH / 2.0f, ship.y - SCREEN_HEIGHT / 2.0f };
+}
+
+SDL_FPoint view_origin(const Game* game) {
+    return (SDL_FPoint){ game->ship.pos.x - SCREEN_WIDTH / 2.0f, game->ship.pos.y - SCREEN_HEIGHT / 2.0f };
+}
+
+static void shift_positions(float* pos_x, float* pos_y, int count, float dx, float dy) {
+    for (int i = 0; i < count; i++) {
+        pos_x[i] -= dx;
+        pos_y[i] -= dy;
+    }
+}
+
+// Lleva la nave de vuelta al centro de la pantalla en coordenadas del mundo y
+// todo lo demás con ella, incluidas las posiciones anteriores para que la
+// interpolación no note nada. Es O(n), pero sólo ocurre cada
+// WORLD_RECENTER_DISTANCE píxeles recorridos, para que los floats no pierdan
+// precisión lejos del origen.
+static void recenter_world(Game* game) {
+    float dx = game->ship.pos.x - SCREEN_WIDTH / 2.0f;
+    float dy = game->ship.pos.y - SCREEN_HEIGHT / 2.0f;
+    game->ship.pos.x -= dx;
+    game->ship.pos.y -= dy;
+    game->ship.prev_pos.x -= dx;
+    game->ship.prev_pos.y -= dy;
+    game->ufo.pos.x -= dx;
+    game->ufo.pos.y -= dy;
+    game->ufo.prev_pos.x -= dx;
+    game->ufo.prev_pos.y -= dy;
+    shift_positions(game->bullets.pos_x, game->bullets.pos_y, game->bullets.count, dx, dy);
+    shift_positions(game->bullets.prev_x, game->bullets.prev_y, game->bullets.count, dx, dy);
+    shift_positions(game->ufo_bullets.pos_x, game->ufo_bullets.pos_y, game->ufo_bullets.count, dx, dy);
+    shift_positions(game->ufo_bullets.prev_x, game->ufo_bullets.prev_y, game->ufo_bullets.count, dx, dy);
+    shift_positions(game->asteroids.pos_x, game->asteroids.pos_y, game->asteroids.count, dx, dy);
+    shift_positions(game->asteroids.prev_x, game->asteroids.prev_y, game->asteroids.count, dx, dy);
+    shift_positions(game->powerups.pos_x, game->powerups.pos_y, game->powerups.count, dx, dy);
+    shift_positions(game->powerups.prev_x, game->powerups.prev_y, game->powerups.count, dx, dy);
+    shift_positions(game->particles.pos_x, game->particles.pos_y, game->particles.count, dx, dy);
+    shift_positions(game->particles.prev_x, game->particles.prev_y, game->particles.count, dx, dy);
+}
+
+void store_previous_state(Game* game) {
+    game->ship.prev_angle = game->ship.angle;
+    game->ship.prev_pos = game->ship.pos;
+    game->ufo.prev_pos = game->ufo.pos;
+
+    // Sólo se copia el tramo vivo [0, count) de cada pool
+    memcpy(game->bullets.prev_x, game->bullets.pos_x, sizeof(float) * game->bullets.count);
+    memcpy(game->bullets.prev_y, game->bullets.pos_y, sizeof(float) * game->bullets.count);
+    memcpy(game->ufo_bullets.prev_x, game->ufo_bullets.pos_x, sizeof(float) * game->ufo_bullets.count);
+    memcpy(game->ufo_bullets.prev_y, game->ufo_bullets.pos_y, sizeof(float) * game->ufo_bullets.count);
+    memcpy(game->asteroids.prev_x, game->asteroids.pos_x, sizeof(float) * game->asteroids.count);
+    memcpy(game->asteroids.prev_y, game->asteroids.pos_y, sizeof(float) * game->asteroids.count);
+    memcpy(game->asteroids.prev_angle, game->asteroids.angle, sizeof(float) * game->asteroids.count);
+    memcpy(game->powerups.prev_x, game->powerups.pos_x, sizeof(float) * game->powerups.count);
+    memcpy(game->powerups.prev_y, game->powerups.pos_y, sizeof(float) * game->powerups.count);
+    game->stars.step = (SDL_FPoint){ 0.0f, 0.0f }; // Hasta que update_stars diga otra cosa, no se mueven
+    memcpy(game->particles.prev_x, game->particles.pos_x, sizeof(float) * game->particles.count);
+    memcpy(game->particles.prev_y, game->particles.pos_y, sizeof(float) * game->particles.count);
+}
+
 // --- Nave ---
 
+// La nave reaparece donde estaba: la cámara no se mueve
 void reset_ship(Game* game, bool invincible) {
-    game->ship.pos = (SDL_FPoint){SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
     game->ship.vel = (SDL_FPoint){0, 0};
     game->ship.angle = -90.0f; // Apuntando hacia arriba
+    game->ship.prev_angle = game->ship.angle;
     game->ship.accelerating = false;
     if (invincible) {
         game->respawn_timer = 3.0f;
@@ -21,17 +478,12 @@ void reset_ship(Game* game, bool invincible) {
 }
 
 void update_ship(Game* game, float dt) {
-    const bool* state = SDL_GetKeyboardState(NULL);
     if (game->state == GAME_STATE_PLAYING && !game->hyperspace_active) {
-        if (state[SDL_SCANCODE_UP] || state[SDL_SCANCODE_W]) {
-            game->ship.accelerating = true;
-        } else {
-            game->ship.accelerating = false;
-        }
-        if (state[SDL_SCANCODE_LEFT] || state[SDL_SCANCODE_A]) {
+        game->ship.accelerating = game->input.thrust;
+        if (game->input.turn_left) {
             game->ship.angle -= SHIP_TURN_SPEED * dt;
         }
-        if (state[SDL_SCANCODE_RIGHT] || state[SDL_SCANCODE_D]) {
+        if (game->input.turn_right) {
             game->ship.angle += SHIP_TURN_SPEED * dt;
         }
     } else {
@@ -47,6 +499,14 @@ void update_ship(Game* game, float dt) {
     // Fricción
     game->ship.vel.x *= (1.0f - SHIP_FRICTION * dt);
     game->ship.vel.y *= (1.0f - SHIP_FRICTION * dt);
+
+    // Sólo se mueve la nave; la cámara la sigue al dibujar
+    game->ship.pos.x += game->ship.vel.x * dt;
+    game->ship.pos.y += game->ship.vel.y * dt;
+    if (SDL_fabsf(game->ship.pos.x - SCREEN_WIDTH / 2.0f) > WORLD_RECENTER_DISTANCE ||
+        SDL_fabsf(game->ship.pos.y - SCREEN_HEIGHT / 2.0f) > WORLD_RECENTER_DISTANCE) {
+        recenter_world(game);
+    }
 }
 
 void render_ship(Game* game) {
@@ -62,48 +522,42 @@ void render_ship(Game* game) {
         }
     }
 
+    // La cámara sigue a la nave: siempre está en el centro de la pantalla
     SDL_FPoint ship_center = { SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f };
 
     // Dibujar escudo si está activo
     if (game->shield_timer > 0) {
-        SDL_SetRenderDrawColor(game->renderer, 100, 100, 255, 100);
-        for (int i = 0; i < 360; i += 15) {
-            float rad1 = i * (M_PI / 180.0f);
-            float rad2 = (i + 15) * (M_PI / 180.0f);
-            SDL_RenderLine(game->renderer, ship_center.x + cosf(rad1) * (SHIP_SIZE + 5), ship_center.y + sinf(rad1) * (SHIP_SIZE + 5),
-                                         ship_center.x + cosf(rad2) * (SHIP_SIZE + 5), ship_center.y + sinf(rad2) * (SHIP_SIZE + 5));
+        SDL_FColor shield_color = {100 / 255.0f, 100 / 255.0f, 1.0f, 100 / 255.0f};
+        SDL_FPoint ring[SHIELD_SEGMENTS + 1];
+        for (int i = 0; i <= SHIELD_SEGMENTS; i++) {
+            ring[i] = place_point(ship_center, shield_ring[i], SHIP_SIZE + 5, 1.0f, 0.0f);
         }
+        batch_polyline(&game->frame.vectors, ring, SHIELD_SEGMENTS + 1, shield_color);
     }
 
-    float angle_rad = game->ship.angle * (M_PI / 180.0f);
+    float angle_rad = lerp_float(game->ship.prev_angle, game->ship.angle, game->render_alpha) * (M_PI / 180.0f);
+    float c = cosf(angle_rad);
+    float s = sinf(angle_rad);
     // Vértices para una forma de nave más clásica
-    SDL_FPoint ship_points[] = {
-        {ship_center.x + cosf(angle_rad) * SHIP_SIZE, ship_center.y + sinf(angle_rad) * SHIP_SIZE},
-        {ship_center.x + cosf(angle_rad + 2.4f) * SHIP_SIZE, ship_center.y + sinf(angle_rad + 2.4f) * SHIP_SIZE},
-        {ship_center.x + cosf(angle_rad - M_PI) * SHIP_SIZE * 0.5f, ship_center.y + sinf(angle_rad - M_PI) * SHIP_SIZE * 0.5f},
-        {ship_center.x + cosf(angle_rad - 2.4f) * SHIP_SIZE, ship_center.y + sinf(angle_rad - 2.4f) * SHIP_SIZE},
-        {ship_center.x + cosf(angle_rad) * SHIP_SIZE, ship_center.y + sinf(angle_rad) * SHIP_SIZE}
-    };
-    SDL_SetRenderDrawColor(game->renderer, 255, 255, 255, 255);
-    SDL_RenderLines(game->renderer, ship_points, 5);
+    SDL_FPoint ship_points[5];
+    for (int i = 0; i < 5; i++) {
+        ship_points[i] = place_point(ship_center, ship_hull[i], 1.0f, c, s);
+    }
+    batch_polyline(&game->frame.vectors, ship_points, 5, (SDL_FColor){1.0f, 1.0f, 1.0f, 1.0f});
 
     if (game->ship.accelerating) {
         // Llama parpadeante y de tamaño variable para más dinamismo
-        float flame_size = SHIP_SIZE * (0.8f + ((float)rand() / RAND_MAX) * 0.4f); // Varía entre 0.8 y 1.2
-        if (rand() % 3 == 0) { // Parpadeo ocasional
+        float flame_size = SHIP_SIZE * (0.8f + rng_float(&game->fx_rng) * 0.4f); // Varía entre 0.8 y 1.2
+        if (rng_int(&game->fx_rng, 3) == 0) { // Parpadeo ocasional
             return;
         }
 
         SDL_FColor flame_color = {1.0f, 0.5f, 0.0f, 1.0f};
-        SDL_Vertex flame_vertices[] = {
-            { {ship_center.x + cosf(angle_rad - M_PI) * flame_size, ship_center.y + sinf(angle_rad - M_PI) * flame_size},
-              flame_color, {0, 0} },
-            { {ship_center.x + cosf(angle_rad - M_PI + 0.5f) * flame_size * 0.5f, ship_center.y + sinf(angle_rad - M_PI + 0.5f) * flame_size * 0.5f},
-              flame_color, {0, 0} },
-            { {ship_center.x + cosf(angle_rad - M_PI - 0.5f) * flame_size * 0.5f, ship_center.y + sinf(angle_rad - M_PI - 0.5f) * flame_size * 0.5f},
-              flame_color, {0, 0} },
-        };
-        SDL_RenderGeometry(game->renderer, NULL, flame_vertices, 3, NULL, 0);
+        batch_triangle(&game->frame.vectors,
+            place_point(ship_center, flame_directions[0], flame_size, c, s),
+            place_point(ship_center, flame_directions[1], flame_size * 0.5f, c, s),
+            place_point(ship_center, flame_directions[2], flame_size * 0.5f, c, s),
+            flame_color);
     }
 }
 
@@ -113,7 +567,7 @@ void activate_hyperspace(Game* game) {
         game->hyperspace_active = true;
         game->hyperspace_timer = HYPERSPACE_DURATION;
         game->hyperspace_cooldown = HYPERSPACE_COOLDOWN;
-        spawn_explosion(game, SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f, (SDL_FColor){0.5f, 0.5f, 1.0f, 1.0f}, 40);
+        spawn_explosion(game, game->ship.pos.x, game->ship.pos.y, (SDL_FColor){0.5f, 0.5f, 1.0f, 1.0f}, 40);
     }
 }
 
@@ -127,219 +581,183 @@ void update_hyperspace(Game* game, float dt) {
         if (game->hyperspace_timer <= 0) {
             game->hyperspace_active = false;
 
-            // Teletransportar el "mundo" a una nueva posición aleatoria
-            float new_x = (float)(rand() % SCREEN_WIDTH);
-            float new_y = (float)(rand() % SCREEN_HEIGHT);
-            float dx = new_x - (SCREEN_WIDTH / 2.0f);
-            float dy = new_y - (SCREEN_HEIGHT / 2.0f);
-
-            for (int i = 0; i < MAX_ASTEROIDS; ++i) {
-                if (game->asteroids[i].active) {
-                    game->asteroids[i].pos.x += dx;
-                    game->asteroids[i].pos.y += dy;
-                }
-            }
-            
-            // Mover el OVNI si está activo
-            if (game->ufo.active) {
-                game->ufo.pos.x += dx;
-                game->ufo.pos.y += dy;
-            }
-
-            // Mover todas las balas (del jugador y del OVNI)
-            for (int i = 0; i < MAX_BULLETS; ++i) {
-                if (game->bullets[i].active) {
-                    game->bullets[i].pos.x += dx;
-                    game->bullets[i].pos.y += dy;
-                }
-                if (game->ufo_bullets[i].active) {
-                    game->ufo_bullets[i].pos.x += dx;
-                    game->ufo_bullets[i].pos.y += dy;
-                }
-            }
-
-            // Mover los power-ups
-            for (int i = 0; i < MAX_POWERUPS; ++i) {
-                if (game->powerups[i].active) {
-                    game->powerups[i].pos.x += dx;
-                    game->powerups[i].pos.y += dy;
-                }
-            }
+            // Teletransportar la nave: el resto del mundo queda desplazado en
+            // pantalla como si lo hubiera movido, pero sólo cambia la nave y la
+            // cámara la sigue
+            float new_x = (float)rng_int(&game->sim_rng, SCREEN_WIDTH);
+            float new_y = (float)rng_int(&game->sim_rng, SCREEN_HEIGHT);
+            game->ship.pos.x -= new_x - (SCREEN_WIDTH / 2.0f);
+            game->ship.pos.y -= new_y - (SCREEN_HEIGHT / 2.0f);
 
             // Reiniciar la velocidad de la nave
             game->ship.vel = (SDL_FPoint){0, 0};
 
-            spawn_explosion(game, SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f, (SDL_FColor){0.8f, 0.8f, 1.0f, 1.0f}, 40);
+            spawn_explosion(game, game->ship.pos.x, game->ship.pos.y, (SDL_FColor){0.8f, 0.8f, 1.0f, 1.0f}, 40);
         }
     }
 }
 
 // --- Balas del Jugador ---
 
+// Crea una bala en (x, y) con la dirección dada; no hace nada si la pool está llena
+static void spawn_bullet(BulletPool* bullets, float x, float y, float angle_rad) {
+    int i = claim_slot(&bullets->count, bullets->capacity, &bullets->dropped);
+    if (i < 0) {
+        return;
+    }
+    bullets->lifetime[i] = BULLET_LIFESPAN;
+    bullets->pos_x[i] = x;
+    bullets->pos_y[i] = y;
+    bullets->prev_x[i] = x;
+    bullets->prev_y[i] = y;
+    bullets->vel_x[i] = cosf(angle_rad) * BULLET_SPEED;
+    bullets->vel_y[i] = sinf(angle_rad) * BULLET_SPEED;
+}
+
 void fire_bullet(Game* game) {
     float base_angle_rad = game->ship.angle * (M_PI / 180.0f);
     if (game->hyperspace_active) return;
     if (game->triple_shot_timer > 0) {
         float angles[] = { base_angle_rad - 0.2f, base_angle_rad, base_angle_rad + 0.2f };
         for (int j = 0; j < 3; j++) {
-            for (int i = 0; i < MAX_BULLETS; i++) {
-                if (!game->bullets[i].active) {
-                    game->bullets[i].active = true;
-                    game->bullets[i].lifetime = BULLET_LIFESPAN;
-                    game->bullets[i].pos = (SDL_FPoint){ SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f };
-                    game->bullets[i].vel.x = cosf(angles[j]) * BULLET_SPEED;
-                    game->bullets[i].vel.y = sinf(angles[j]) * BULLET_SPEED;
-                    break; // Dispara una bala y busca el siguiente slot
-                }
-            }
+            spawn_bullet(&game->bullets, game->ship.pos.x, game->ship.pos.y, angles[j]);
         }
     } else {
-        for (int i = 0; i < MAX_BULLETS; i++) {
-            if (!game->bullets[i].active) {
-                game->bullets[i].active = true;
-                game->bullets[i].lifetime = BULLET_LIFESPAN;
-                game->bullets[i].pos = (SDL_FPoint){ SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f };
-                game->bullets[i].vel.x = cosf(base_angle_rad) * BULLET_SPEED;
-                game->bullets[i].vel.y = sinf(base_angle_rad) * BULLET_SPEED;
-                return;
-            }
-        }
+        spawn_bullet(&game->bullets, game->ship.pos.x, game->ship.pos.y, base_angle_rad);
     }
 }
 
+int move_bullets(Game* game, float dt, int begin, int end) {
+    BulletPool* bullets = &game->bullets;
+    int n = end - begin;
+    kinematics->integrate(bullets->pos_x + begin, bullets->pos_y + begin, bullets->vel_x + begin, bullets->vel_y + begin, n, dt);
+
+    // Caducan por tiempo o al salir de la pantalla
+    SDL_FPoint origin = view_origin(game);
+    SDL_FRect screen = { origin.x, origin.y, SCREEN_WIDTH, SCREEN_HEIGHT };
+    return kinematics->expire(bullets->lifetime + begin, bullets->pos_x + begin, bullets->pos_y + begin,
+                              bullets->expired + begin, n, dt, &screen);
+}
+
 void update_bullets(Game* game, float dt) {
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (game->bullets[i].active) {
-            game->bullets[i].pos.x += game->bullets[i].vel.x * dt;
-            game->bullets[i].pos.y += game->bullets[i].vel.y * dt;
-
-            // El jugador está siempre en el centro. Para simular su movimiento,
-            // movemos el resto del mundo en la dirección opuesta.
-            game->bullets[i].pos.x -= game->ship.vel.x * dt;
-            game->bullets[i].pos.y -= game->ship.vel.y * dt;
-
-            game->bullets[i].lifetime -= dt;
-
-            if (game->bullets[i].lifetime <= 0 ||
-                game->bullets[i].pos.x < 0 || game->bullets[i].pos.x > SCREEN_WIDTH ||
-                game->bullets[i].pos.y < 0 || game->bullets[i].pos.y > SCREEN_HEIGHT) {
-                game->bullets[i].active = false;
-            }
-        }
+    if (move_bullets(game, dt, 0, game->bullets.count) > 0) {
+        remove_expired_bullets(&game->bullets);
     }
 }
 
 void render_bullets(Game* game) {
-    SDL_SetRenderDrawColor(game->renderer, 255, 255, 255, 255);
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (game->bullets[i].active) {
-            // Dibujar la bala como una pequeña línea para dar sensación de velocidad
-            float speed = sqrtf(game->bullets[i].vel.x * game->bullets[i].vel.x + game->bullets[i].vel.y * game->bullets[i].vel.y);
-            float end_x = game->bullets[i].pos.x - (game->bullets[i].vel.x / speed) * 4.0f; // 4 píxeles de largo
-            float end_y = game->bullets[i].pos.y - (game->bullets[i].vel.y / speed) * 4.0f;
-            SDL_RenderLine(game->renderer, game->bullets[i].pos.x, game->bullets[i].pos.y, end_x, end_y);
-        }
+    const BulletPool* bullets = &game->bullets;
+    SDL_FColor white = {1.0f, 1.0f, 1.0f, 1.0f};
+    for (int i = 0; i < bullets->count; i++) {
+        // Dibujar la bala como una pequeña línea para dar sensación de velocidad
+        SDL_FPoint pos = interpolate_pos(game, bullets->prev_x[i], bullets->prev_y[i], bullets->pos_x[i], bullets->pos_y[i]);
+        float speed = sqrtf(bullets->vel_x[i] * bullets->vel_x[i] + bullets->vel_y[i] * bullets->vel_y[i]);
+        float end_x = pos.x - (bullets->vel_x[i] / speed) * 4.0f; // 4 píxeles de largo
+        float end_y = pos.y - (bullets->vel_y[i] / speed) * 4.0f;
+        batch_line(&game->frame.vectors, pos.x, pos.y, end_x, end_y, white);
     }
 }
 
 // --- Asteroides ---
 
 void create_asteroid(Game* game, float x, float y, int size, const SDL_FPoint* parent_vel, const SDL_FPoint* bullet_vel) {
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        if (!game->asteroids[i].active) {
-            game->asteroids[i].active = true;
-            game->asteroids[i].pos = (SDL_FPoint){x, y};
-            game->asteroids[i].size = size;
-            game->asteroids[i].angle = 0.0f; // El ángulo inicial no es tan importante, lo ponemos a 0.
-            game->asteroids[i].rotation_speed = (((float)rand() / RAND_MAX) * 2.0f - 1.0f) * (M_PI / 2.0f); // Entre -PI/2 y +PI/2 rad/s
-
-            if (parent_vel) {
-                // Es un fragmento: hereda velocidad + impulso de la bala + explosión
-                float angle = ((float)rand() / RAND_MAX) * 2.0f * M_PI;
-                float speed = (ASTEROID_SPEED / size) * (0.8f + ((float)rand() / RAND_MAX) * 0.4f); // Velocidad de explosión variable
-
-                game->asteroids[i].vel.x = parent_vel->x + cosf(angle) * speed * game->difficulty_factor;
-                game->asteroids[i].vel.y = parent_vel->y + sinf(angle) * speed * game->difficulty_factor;
-
-                // Añadir un pequeño empuje de la bala
-                if (bullet_vel) {
-                    game->asteroids[i].vel.x += bullet_vel->x * 0.05f;
-                    game->asteroids[i].vel.y += bullet_vel->y * 0.05f;
-                }
-            } else {
-                // Es un asteroide nuevo (inicio de nivel), velocidad completamente aleatoria
-                float angle = ((float)rand() / RAND_MAX) * 2.0f * M_PI;
-                game->asteroids[i].vel.x = cosf(angle) * (ASTEROID_SPEED / size) * game->difficulty_factor;
-                game->asteroids[i].vel.y = sinf(angle) * (ASTEROID_SPEED / size) * game->difficulty_factor;
-            }
+    AsteroidPool* asteroids = &game->asteroids;
+    int i = claim_slot(&asteroids->count, asteroids->capacity, &asteroids->dropped);
+    if (i < 0) {
+        return;
+    }
 
-            for (int j = 0; j < ASTEROID_MAX_VERTS; j++) {
-                game->asteroids[i].vert_offsets[j] = 0.7f + ((float)rand() / (float)RAND_MAX) * 0.6f;
-            }
-            return;
+    asteroids->pos_x[i] = x;
+    asteroids->pos_y[i] = y;
+    asteroids->prev_x[i] = x;
+    asteroids->prev_y[i] = y;
+    asteroids->size[i] = size;
+    asteroids->angle[i] = 0.0f; // El ángulo inicial no es tan importante, lo ponemos a 0.
+    asteroids->prev_angle[i] = 0.0f;
+    asteroids->rotation_speed[i] = (rng_float(&game->sim_rng) * 2.0f - 1.0f) * (M_PI / 2.0f); // Entre -PI/2 y +PI/2 rad/s
+
+    if (parent_vel) {
+        // Es un fragmento: hereda velocidad + impulso de la bala + explosión
+        float angle = rng_float(&game->sim_rng) * 2.0f * M_PI;
+        float speed = (ASTEROID_SPEED / size) * (0.8f + rng_float(&game->sim_rng) * 0.4f); // Velocidad de explosión variable
+
+        asteroids->vel_x[i] = parent_vel->x + cosf(angle) * speed * game->difficulty_factor;
+        asteroids->vel_y[i] = parent_vel->y + sinf(angle) * speed * game->difficulty_factor;
+
+        // Añadir un pequeño empuje de la bala
+        if (bullet_vel) {
+            asteroids->vel_x[i] += bullet_vel->x * 0.05f;
+            asteroids->vel_y[i] += bullet_vel->y * 0.05f;
         }
+    } else {
+        // Es un asteroide nuevo (inicio de nivel), velocidad completamente aleatoria
+        float angle = rng_float(&game->sim_rng) * 2.0f * M_PI;
+        asteroids->vel_x[i] = cosf(angle) * (ASTEROID_SPEED / size) * game->difficulty_factor;
+        asteroids->vel_y[i] = sinf(angle) * (ASTEROID_SPEED / size) * game->difficulty_factor;
+    }
+
+    // Radio de cada vértice entre el 70% y el 130% del nominal
+    for (int j = 0; j < ASTEROID_MAX_VERTS; j++) {
+        float r = size * 10.0f * (0.7f + rng_float(&game->sim_rng) * 0.6f);
+        asteroids->outline[i][j] = (SDL_FPoint){ asteroid_directions[j].x * r, asteroid_directions[j].y * r };
     }
 }
+
 void start_level(Game* game) {
     game->level++;
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        game->asteroids[i].active = false;
-    }
+    game->asteroids.count = 0;
 
     int num_asteroids = game->level + 2;
-    if (num_asteroids > MAX_ASTEROIDS) {
-        num_asteroids = MAX_ASTEROIDS;
+    if (num_asteroids > game->asteroids.capacity) {
+        num_asteroids = game->asteroids.capacity;
     }
 
+    SDL_FPoint origin = view_origin(game);
     for (int i = 0; i < num_asteroids; i++) {
         int x, y;
-        if (rand() % 2 == 0) {
-            x = (rand() % 2 == 0) ? -20 : SCREEN_WIDTH + 20;
-            y = rand() % SCREEN_HEIGHT;
+        if (rng_int(&game->sim_rng, 2) == 0) {
+            x = (rng_int(&game->sim_rng, 2) == 0) ? -20 : SCREEN_WIDTH + 20;
+            y = rng_int(&game->sim_rng, SCREEN_HEIGHT);
         } else {
-            x = rand() % SCREEN_WIDTH;
-            y = (rand() % 2 == 0) ? -20 : SCREEN_HEIGHT + 20;
+            x = rng_int(&game->sim_rng, SCREEN_WIDTH);
+            y = (rng_int(&game->sim_rng, 2) == 0) ? -20 : SCREEN_HEIGHT + 20;
         }
-        create_asteroid(game, x, y, 3, NULL, NULL); // NULL para indicar que no hay padre
+        create_asteroid(game, origin.x + x, origin.y + y, 3, NULL, NULL); // NULL para indicar que no hay padre
     }
 }
 
-void update_asteroids(Game* game, float dt) {
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        if (game->asteroids[i].active) {
-            game->asteroids[i].pos.x += game->asteroids[i].vel.x * dt;
-            game->asteroids[i].pos.y += game->asteroids[i].vel.y * dt;
-
-            // El jugador está siempre en el centro. Para simular su movimiento,
-            // movemos el resto del mundo en la dirección opuesta.
-            game->asteroids[i].pos.x -= game->ship.vel.x * dt;
-            game->asteroids[i].pos.y -= game->ship.vel.y * dt;
-
-            game->asteroids[i].angle += game->asteroids[i].rotation_speed * dt;
+void move_asteroids(Game* game, float dt, int begin, int end) {
+    AsteroidPool* asteroids = &game->asteroids;
+    int n = end - begin;
+    kinematics->integrate(asteroids->pos_x + begin, asteroids->pos_y + begin, asteroids->vel_x + begin, asteroids->vel_y + begin, n, dt);
+    kinematics->advance(asteroids->angle + begin, asteroids->rotation_speed + begin, n, dt);
+
+    // Wrap en los bordes de la vista, que sigue a la nave
+    SDL_FPoint origin = view_origin(game);
+    kinematics->wrap_reset(asteroids->pos_x + begin, n, origin.x - 50, origin.x + SCREEN_WIDTH + 50,
+                           origin.x - 49, origin.x + SCREEN_WIDTH + 49);
+    kinematics->wrap_reset(asteroids->pos_y + begin, n, origin.y - 50, origin.y + SCREEN_HEIGHT + 50,
+                           origin.y - 49, origin.y + SCREEN_HEIGHT + 49);
+}
 
-            // Screen wrapping
-            if (game->asteroids[i].pos.x < -50) game->asteroids[i].pos.x = SCREEN_WIDTH + 49;
-            if (game->asteroids[i].pos.x > SCREEN_WIDTH + 50) game->asteroids[i].pos.x = -49;
-            if (game->asteroids[i].pos.y < -50) game->asteroids[i].pos.y = SCREEN_HEIGHT + 49;
-            if (game->asteroids[i].pos.y > SCREEN_HEIGHT + 50) game->asteroids[i].pos.y = -49;
-        }
-    }
+void update_asteroids(Game* game, float dt) {
+    move_asteroids(game, dt, 0, game->asteroids.count);
 }
 
 void render_asteroids(Game* game) {
-    SDL_SetRenderDrawColor(game->renderer, 255, 255, 255, 255);
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        if (game->asteroids[i].active) {
-            SDL_FPoint points[ASTEROID_MAX_VERTS + 1];
-            for (int j = 0; j < ASTEROID_MAX_VERTS; j++) { // Corregido: el ángulo del asteroide ya está en radianes
-                float a = (float)j / ASTEROID_MAX_VERTS * 2.0f * M_PI + game->asteroids[i].angle;
-                float r = game->asteroids[i].size * 10.0f * game->asteroids[i].vert_offsets[j];
-                points[j].x = game->asteroids[i].pos.x + cosf(a) * r;
-                points[j].y = game->asteroids[i].pos.y + sinf(a) * r;
-            }
-            points[ASTEROID_MAX_VERTS] = points[0];
-            SDL_RenderLines(game->renderer, points, ASTEROID_MAX_VERTS + 1);
+    const AsteroidPool* asteroids = &game->asteroids;
+    SDL_FColor white = {1.0f, 1.0f, 1.0f, 1.0f};
+    for (int i = 0; i < asteroids->count; i++) {
+        SDL_FPoint points[ASTEROID_MAX_VERTS + 1];
+        SDL_FPoint pos = interpolate_pos(game, asteroids->prev_x[i], asteroids->prev_y[i], asteroids->pos_x[i], asteroids->pos_y[i]);
+        float angle = lerp_float(asteroids->prev_angle[i], asteroids->angle[i], game->render_alpha); // En radianes
+        float c = cosf(angle);
+        float s = sinf(angle);
+        for (int j = 0; j < ASTEROID_MAX_VERTS; j++) {
+            points[j] = place_point(pos, asteroids->outline[i][j], 1.0f, c, s);
         }
+        points[ASTEROID_MAX_VERTS] = points[0];
+        batch_polyline(&game->frame.vectors, points, ASTEROID_MAX_VERTS + 1, white);
     }
 }
 
@@ -348,21 +766,23 @@ void render_asteroids(Game* game) {
 void spawn_ufo(Game* game) {
     game->ufo.active = true;
     game->ufo.shoot_timer = 1.0f;
-    game->ufo.type = (rand() % 4 == 0) ? UFO_SMALL : UFO_LARGE; // 25% de probabilidad de OVNI pequeño
+    game->ufo.type = (rng_int(&game->sim_rng, 4) == 0) ? UFO_SMALL : UFO_LARGE; // 25% de probabilidad de OVNI pequeño
+    SDL_FPoint origin = view_origin(game);
 
-    if (rand() % 2 == 0) {
-        game->ufo.pos.x = -30.0f;
+    if (rng_int(&game->sim_rng, 2) == 0) {
+        game->ufo.pos.x = origin.x - 30.0f;
         game->ufo.vel.x = ((game->ufo.type == UFO_SMALL) ? UFO_SPEED * 1.5f : UFO_SPEED) * game->difficulty_factor;
     } else {
-        game->ufo.pos.x = SCREEN_WIDTH + 30.0f;
+        game->ufo.pos.x = origin.x + SCREEN_WIDTH + 30.0f;
         game->ufo.vel.x = ((game->ufo.type == UFO_SMALL) ? -UFO_SPEED * 1.5f : -UFO_SPEED) * game->difficulty_factor;
     }
-    game->ufo.pos.y = (float)(rand() % (SCREEN_HEIGHT / 2)) + (SCREEN_HEIGHT / 4); // Aparece en la mitad central
+    game->ufo.pos.y = origin.y + (float)rng_int(&game->sim_rng, SCREEN_HEIGHT / 2) + (SCREEN_HEIGHT / 4); // Aparece en la mitad central
     game->ufo.vel.y = 0;
+    game->ufo.prev_pos = game->ufo.pos;
 
     if (game->ufo.type == UFO_SMALL) {
         // El OVNI pequeño tiene un movimiento vertical sinusoidal
-        if (rand() % 2 == 0) {
+        if (rng_int(&game->sim_rng, 2) == 0) {
             game->ufo.vel.y = UFO_SPEED * 0.5f;
         } else {
             game->ufo.vel.y = -UFO_SPEED * 0.5f;
@@ -379,37 +799,30 @@ void update_ufo(Game* game, float dt) {
         return;
     }
 
+    // Los límites son los de la vista, que se mueve con la nave
+    SDL_FPoint origin = view_origin(game);
     if (game->ufo.type == UFO_SMALL) {
-        if (game->ufo.pos.y < SCREEN_HEIGHT * 0.1f || game->ufo.pos.y > SCREEN_HEIGHT * 0.9f) {
+        float screen_y = game->ufo.pos.y - origin.y;
+        if (screen_y < SCREEN_HEIGHT * 0.1f || screen_y > SCREEN_HEIGHT * 0.9f) {
             game->ufo.vel.y *= -1;
         }
     }
     game->ufo.pos.x += game->ufo.vel.x * dt;
     game->ufo.pos.y += game->ufo.vel.y * dt;
-    game->ufo.pos.x -= game->ship.vel.x * dt;
-    game->ufo.pos.y -= game->ship.vel.y * dt;
 
     game->ufo.shoot_timer -= dt;
     if (game->ufo.shoot_timer <= 0) {
-        for (int i = 0; i < MAX_BULLETS; i++) {
-            if (!game->ufo_bullets[i].active) {
-                game->ufo_bullets[i].active = true;
-                game->ufo_bullets[i].lifetime = BULLET_LIFESPAN;
-                game->ufo_bullets[i].pos = game->ufo.pos;
-                float angle = atan2f((SCREEN_HEIGHT / 2.0f) - game->ufo.pos.y, (SCREEN_WIDTH / 2.0f) - game->ufo.pos.x);
-                game->ufo_bullets[i].vel.x = cosf(angle) * BULLET_SPEED;
-                game->ufo_bullets[i].vel.y = sinf(angle) * BULLET_SPEED;
-                break;
-            }
-        }
+        float angle = atan2f(game->ship.pos.y - game->ufo.pos.y, game->ship.pos.x - game->ufo.pos.x);
+        spawn_bullet(&game->ufo_bullets, game->ufo.pos.x, game->ufo.pos.y, angle);
         if (game->ufo.type == UFO_SMALL) {
-            game->ufo.shoot_timer = (0.5f + (float)(rand() % 50) / 100.0f) / game->difficulty_factor; // Dispara más rápido
+            game->ufo.shoot_timer = (0.5f + (float)rng_int(&game->sim_rng, 50) / 100.0f) / game->difficulty_factor; // Dispara más rápido
         } else {
-            game->ufo.shoot_timer = (1.0f + (float)(rand() % 100) / 100.0f) / game->difficulty_factor;
+            game->ufo.shoot_timer = (1.0f + (float)rng_int(&game->sim_rng, 100) / 100.0f) / game->difficulty_factor;
         }
     }
 
-    if (game->ufo.pos.x < -50 || game->ufo.pos.x > SCREEN_WIDTH + 50) {
+    float screen_x = game->ufo.pos.x - origin.x;
+    if (screen_x < -50 || screen_x > SCREEN_WIDTH + 50) {
         game->ufo.active = false;
         game->ufo.spawn_timer = UFO_SPAWN_TIME;
     }
@@ -417,161 +830,224 @@ void update_ufo(Game* game, float dt) {
 
 void render_ufo(Game* game) {
     if (game->ufo.active) {
-        SDL_SetRenderDrawColor(game->renderer, 200, 50, 200, 255);
+        SDL_FColor ufo_color = {200 / 255.0f, 50 / 255.0f, 200 / 255.0f, 1.0f};
         float ufo_size = (game->ufo.type == UFO_SMALL) ? SHIP_SIZE * 0.8f : SHIP_SIZE * 1.6f;
+        SDL_FPoint pos = interpolate_pos(game, game->ufo.prev_pos.x, game->ufo.prev_pos.y, game->ufo.pos.x, game->ufo.pos.y);
 
         // Forma de platillo volante clásico
         SDL_FPoint body_points[] = {
-            {game->ufo.pos.x - ufo_size, game->ufo.pos.y},
-            {game->ufo.pos.x - ufo_size * 0.6f, game->ufo.pos.y - ufo_size * 0.4f},
-            {game->ufo.pos.x + ufo_size * 0.6f, game->ufo.pos.y - ufo_size * 0.4f},
-            {game->ufo.pos.x + ufo_size, game->ufo.pos.y},
-            {game->ufo.pos.x - ufo_size, game->ufo.pos.y}
+            {pos.x - ufo_size, pos.y},
+            {pos.x - ufo_size * 0.6f, pos.y - ufo_size * 0.4f},
+            {pos.x + ufo_size * 0.6f, pos.y - ufo_size * 0.4f},
+            {pos.x + ufo_size, pos.y},
+            {pos.x - ufo_size, pos.y}
         };
-        SDL_RenderLines(game->renderer, body_points, 5);
+        batch_polyline(&game->frame.vectors, body_points, 5, ufo_color);
 
         SDL_FPoint dome_points[] = {
-            {game->ufo.pos.x - ufo_size * 0.4f, game->ufo.pos.y - ufo_size * 0.4f},
-            {game->ufo.pos.x, game->ufo.pos.y - ufo_size * 0.8f},
-            {game->ufo.pos.x + ufo_size * 0.4f, game->ufo.pos.y - ufo_size * 0.4f}
+            {pos.x - ufo_size * 0.4f, pos.y - ufo_size * 0.4f},
+            {pos.x, pos.y - ufo_size * 0.8f},
+            {pos.x + ufo_size * 0.4f, pos.y - ufo_size * 0.4f}
         };
-        SDL_RenderLines(game->renderer, dome_points, 3);
+        batch_polyline(&game->frame.vectors, dome_points, 3, ufo_color);
     }
 }
 
 // --- Balas del OVNI ---
 
 void update_ufo_bullets(Game* game, float dt) {
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (game->ufo_bullets[i].active) {
-            game->ufo_bullets[i].pos.x += game->ufo_bullets[i].vel.x * dt;
-            game->ufo_bullets[i].pos.y += game->ufo_bullets[i].vel.y * dt;
-            game->ufo_bullets[i].pos.x -= game->ship.vel.x * dt;
-            game->ufo_bullets[i].pos.y -= game->ship.vel.y * dt;
-            game->ufo_bullets[i].lifetime -= dt;
-
-            if (game->ufo_bullets[i].lifetime <= 0) {
-                game->ufo_bullets[i].active = false;
-            }
-        }
+    BulletPool* bullets = &game->ufo_bullets;
+    kinematics->integrate(bullets->pos_x, bullets->pos_y, bullets->vel_x, bullets->vel_y, bullets->count, dt);
+    if (kinematics->expire(bullets->lifetime, bullets->pos_x, bullets->pos_y, bullets->expired, bullets->count, dt, NULL) > 0) {
+        remove_expired_bullets(bullets);
     }
 }
 
 void render_ufo_bullets(Game* game) {
-    SDL_SetRenderDrawColor(game->renderer, 255, 0, 0, 255);
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (game->ufo_bullets[i].active) {
-            // Dibujar un pequeño cuadrado para que sea más visible
-            SDL_FRect bullet_rect = { game->ufo_bullets[i].pos.x - 1, game->ufo_bullets[i].pos.y - 1, 3.0f, 3.0f };
-            SDL_RenderFillRect(game->renderer, &bullet_rect);
-        }
+    const BulletPool* bullets = &game->ufo_bullets;
+    SDL_FColor red = {1.0f, 0.0f, 0.0f, 1.0f};
+    for (int i = 0; i < bullets->count; i++) {
+        // Dibujar un pequeño cuadrado para que sea más visible
+        SDL_FPoint pos = interpolate_pos(game, bullets->prev_x[i], bullets->prev_y[i], bullets->pos_x[i], bullets->pos_y[i]);
+        SDL_FRect bullet_rect = { pos.x - 1, pos.y - 1, 3.0f, 3.0f };
+        batch_fill_rect(&game->frame.vectors, &bullet_rect, red);
     }
 }
 
 // --- Power-ups ---
 
 void spawn_powerup(Game* game, float x, float y) {
-    for (int i = 0; i < MAX_POWERUPS; i++) {
-        if (!game->powerups[i].active) {
-            game->powerups[i].active = true;
-            game->powerups[i].pos = (SDL_FPoint){x, y};
-            game->powerups[i].vel = (SDL_FPoint){0, 0}; // Los power-ups no se mueven por sí mismos
-            game->powerups[i].lifetime = POWERUP_LIFESPAN;
-            game->powerups[i].type = (rand() % 2 == 0) ? POWERUP_SHIELD : POWERUP_TRIPLE_SHOT;
-            return;
-        }
+    PowerUpPool* powerups = &game->powerups;
+    int i = claim_slot(&powerups->count, powerups->capacity, &powerups->dropped);
+    if (i < 0) {
+        return;
     }
+    powerups->pos_x[i] = x;
+    powerups->pos_y[i] = y;
+    powerups->prev_x[i] = x;
+    powerups->prev_y[i] = y;
+    powerups->lifetime[i] = POWERUP_LIFESPAN;
+    powerups->type[i] = (rng_int(&game->sim_rng, 2) == 0) ? POWERUP_SHIELD : POWERUP_TRIPLE_SHOT;
 }
 
 void update_powerups(Game* game, float dt) {
-    for (int i = 0; i < MAX_POWERUPS; i++) {
-        if (game->powerups[i].active) {
-            // Movimiento relativo al mundo
-            game->powerups[i].pos.x -= game->ship.vel.x * dt;
-            game->powerups[i].pos.y -= game->ship.vel.y * dt;
-
-            game->powerups[i].lifetime -= dt;
-            if (game->powerups[i].lifetime <= 0) {
-                game->powerups[i].active = false;
-            }
+    PowerUpPool* powerups = &game->powerups;
+    for (int i = powerups->count - 1; i >= 0; i--) {
+        powerups->lifetime[i] -= dt;
+        if (powerups->lifetime[i] <= 0) {
+            remove_powerup(powerups, i);
         }
     }
 }
 
 void render_powerups(Game* game) {
-    for (int i = 0; i < MAX_POWERUPS; i++) {
-        if (game->powerups[i].active) {
-            // Parpadeo para llamar la atención
-            if ((int)(game->powerups[i].lifetime * 4) % 2 == 0) {
-                continue;
-            }
+    const PowerUpPool* powerups = &game->powerups;
+    for (int i = 0; i < powerups->count; i++) {
+        // Parpadeo para llamar la atención
+        if ((int)(powerups->lifetime[i] * 4) % 2 == 0) {
+            continue;
+        }
 
-            SDL_FRect rect = {
-                game->powerups[i].pos.x - POWERUP_SIZE / 2,
-                game->powerups[i].pos.y - POWERUP_SIZE / 2,
-                POWERUP_SIZE,
-                POWERUP_SIZE
-            };
-
-            if (game->powerups[i].type == POWERUP_SHIELD) {
-                SDL_SetRenderDrawColor(game->renderer, 100, 100, 255, 255); // Azul para escudo
-            } else { // POWERUP_TRIPLE_SHOT
-                SDL_SetRenderDrawColor(game->renderer, 255, 165, 0, 255); // Naranja para disparo triple
-            }
-            SDL_RenderFillRect(game->renderer, &rect);
+        SDL_FPoint pos = interpolate_pos(game, powerups->prev_x[i], powerups->prev_y[i], powerups->pos_x[i], powerups->pos_y[i]);
+        SDL_FRect rect = {
+            pos.x - POWERUP_SIZE / 2,
+            pos.y - POWERUP_SIZE / 2,
+            POWERUP_SIZE,
+            POWERUP_SIZE
+        };
 
-            // Borde blanco
-            SDL_SetRenderDrawColor(game->renderer, 255, 255, 255, 255);
-            SDL_RenderRect(game->renderer, &rect);
+        SDL_FColor fill;
+        if (powerups->type[i] == POWERUP_SHIELD) {
+            fill = (SDL_FColor){100 / 255.0f, 100 / 255.0f, 1.0f, 1.0f}; // Azul para escudo
+        } else { // POWERUP_TRIPLE_SHOT
+            fill = (SDL_FColor){1.0f, 165 / 255.0f, 0.0f, 1.0f}; // Naranja para disparo triple
         }
+        batch_fill_rect(&game->frame.vectors, &rect, fill);
+
+        // Borde blanco
+        SDL_FPoint border[] = {
+            {rect.x, rect.y}, {rect.x + rect.w, rect.y}, {rect.x + rect.w, rect.y + rect.h}, {rect.x, rect.y + rect.h}, {rect.x, rect.y}
+        };
+        batch_polyline(&game->frame.vectors, border, 5, (SDL_FColor){1.0f, 1.0f, 1.0f, 1.0f});
     }
 }
 
 // --- Fondo de Estrellas ---
 
+// Las capas más altas (cercanas) se mueven más rápido
+static float star_parallax(int layer) {
+    return 0.1f + (float)layer * 0.2f;
+}
+
+static void swap_stars(StarPool* stars, int a, int b) {
+    float x = stars->pos_x[a];
+    float y = stars->pos_y[a];
+    float parallax = stars->parallax[a];
+    stars->pos_x[a] = stars->pos_x[b];
+    stars->pos_y[a] = stars->pos_y[b];
+    stars->parallax[a] = stars->parallax[b];
+    stars->pos_x[b] = x;
+    stars->pos_y[b] = y;
+    stars->parallax[b] = parallax;
+}
+
 void init_stars(Game* game) {
-    for (int i = 0; i < MAX_STARS; i++) {
-        game->stars[i].pos.x = (float)(rand() % SCREEN_WIDTH);
-        game->stars[i].pos.y = (float)(rand() % SCREEN_HEIGHT);
-        game->stars[i].layer = rand() % 3; // Capas 0, 1, o 2
+    StarPool* stars = &game->stars;
+    for (int i = 0; i < stars->capacity; i++) {
+        stars->pos_x[i] = (float)rng_int(&game->fx_rng, SCREEN_WIDTH);
+        stars->pos_y[i] = (float)rng_int(&game->fx_rng, SCREEN_HEIGHT);
+        stars->parallax[i] = star_parallax(rng_int(&game->fx_rng, STAR_LAYERS));
+    }
+    stars->count = stars->capacity;
+    stars->step = (SDL_FPoint){ 0.0f, 0.0f };
+    SDL_memset(stars->offset, 0, sizeof(stars->offset));
+
+    // Agrupar por capa para dibujar cada una de una vez. La paralaje crece con
+    // la capa, así que basta una partición en tres alrededor de la capa media.
+    float middle = star_parallax(1);
+    int low = 0, mid = 0, high = stars->count;
+    while (mid < high) {
+        if (stars->parallax[mid] < middle) {
+            swap_stars(stars, low++, mid++);
+        } else if (stars->parallax[mid] > middle) {
+            swap_stars(stars, mid, --high);
+        } else {
+            mid++;
+        }
     }
+    stars->layer_start[0] = 0;
+    stars->layer_start[1] = low;
+    stars->layer_start[2] = high;
+    stars->layer_start[3] = stars->count;
+}
+
+// Lleva v a [0, size); el paso de un tick siempre es menor que size
+static float wrap_offset(float v, float size) {
+    if (v < 0.0f) v += size;
+    if (v >= size) v -= size;
+    return v;
 }
 
 void update_stars(Game* game, float dt) {
-    for (int i = 0; i < MAX_STARS; i++) {
-        // El multiplicador de capa hace que las capas más altas (cercanas) se muevan más rápido
-        float speed_multiplier = 0.1f + (float)game->stars[i].layer * 0.2f;
+    StarPool* stars = &game->stars;
+    // Todas las estrellas de una capa se mueven lo mismo: basta con avanzar el
+    // desplazamiento de cada capa. render_stars usa step para interpolar.
+    stars->step = (SDL_FPoint){ game->ship.vel.x * dt, game->ship.vel.y * dt };
+    for (int layer = 0; layer < STAR_LAYERS; layer++) {
+        float parallax = star_parallax(layer);
+        stars->offset[layer].x = wrap_offset(stars->offset[layer].x + stars->step.x * parallax, SCREEN_WIDTH);
+        stars->offset[layer].y = wrap_offset(stars->offset[layer].y + stars->step.y * parallax, SCREEN_HEIGHT);
+    }
+}
 
-        game->stars[i].pos.x -= game->ship.vel.x * dt * speed_multiplier;
-        game->stars[i].pos.y -= game->ship.vel.y * dt * speed_multiplier;
+// Posición fija menos desplazamiento de la capa, de vuelta a la pantalla
+static inline float wrap_star(float v, float size) {
+    return v < 0.0f ? v + size : v;
+}
 
-        // Screen wrapping para las estrellas
-        if (game->stars[i].pos.x < 0) {
-            game->stars[i].pos.x += SCREEN_WIDTH;
-        } else if (game->stars[i].pos.x >= SCREEN_WIDTH) {
-            game->stars[i].pos.x -= SCREEN_WIDTH;
+void render_stars(Game* game) {
+    StarPool* stars = &game->stars;
+    float lag = 1.0f - game->render_alpha;
+
+    for (int layer = 0; layer < STAR_LAYERS; layer++) {
+        int first = stars->layer_start[layer];
+        int count = stars->layer_start[layer + 1] - first;
+        if (count == 0) {
+            continue;
         }
 
-        if (game->stars[i].pos.y < 0) {
-            game->stars[i].pos.y += SCREEN_HEIGHT;
-        } else if (game->stars[i].pos.y >= SCREEN_HEIGHT) {
-            game->stars[i].pos.y -= SCREEN_HEIGHT;
-        }
-    }
-}
+        // Interpolar es deshacer la parte del último paso que aún no toca mostrar.
+        // Igual para toda la capa; una estrella que acaba de hacer wrap queda un
+        // instante fuera del borde en vez de cruzar la pantalla.
+        float parallax = star_parallax(layer);
+        float shift_x = stars->offset[layer].x - stars->step.x * parallax * lag;
+        float shift_y = stars->offset[layer].y - stars->step.y * parallax * lag;
+        const float* pos_x = stars->pos_x + first;
+        const float* pos_y = stars->pos_y + first;
 
-void render_stars(Game* game) {
-    for (int i = 0; i < MAX_STARS; i++) {
         // Las estrellas más lejanas (capa 0) son más tenues
-        Uint8 brightness = 80 + game->stars[i].layer * 80;
-        SDL_SetRenderDrawColor(game->renderer, brightness, brightness, brightness, 255);
+        Uint8 brightness = 80 + layer * 80;
+        SDL_Color color = { brightness, brightness, brightness, 255 };
 
-        // Las estrellas más cercanas (capa 2) pueden ser un poco más grandes
-        if (game->stars[i].layer == 2) {
-            SDL_FRect star_rect = { game->stars[i].pos.x, game->stars[i].pos.y, 2.0f, 2.0f };
-            SDL_RenderFillRect(game->renderer, &star_rect);
+        // Las estrellas más cercanas (última capa) son cuadrados de 2x2
+        if (layer == STAR_LAYERS - 1) {
+            SDL_FRect* rects = record_rects(&game->frame, count, color);
+            if (!rects) {
+                continue;
+            }
+            for (int i = 0; i < count; i++) {
+                rects[i] = (SDL_FRect){ wrap_star(pos_x[i] - shift_x, SCREEN_WIDTH),
+                                        wrap_star(pos_y[i] - shift_y, SCREEN_HEIGHT), 2.0f, 2.0f };
+            }
         } else {
-            SDL_RenderPoint(game->renderer, game->stars[i].pos.x, game->stars[i].pos.y);
+            SDL_FPoint* points = record_points(&game->frame, count, color);
+            if (!points) {
+                continue;
+            }
+            for (int i = 0; i < count; i++) {
+                points[i].x = wrap_star(pos_x[i] - shift_x, SCREEN_WIDTH);
+                points[i].y = wrap_star(pos_y[i] - shift_y, SCREEN_HEIGHT);
+            }
         }
     }
 }
@@ -579,187 +1055,274 @@ void render_stars(Game* game) {
 // --- Efectos (Explosiones) ---
 
 void spawn_explosion(Game* game, float x, float y, SDL_FColor color, int count) {
+    PROFILE_BEGIN(PROFILE_EXPLOSION);
+    ParticlePool* particles = &game->particles;
     for (int i = 0; i < count; ++i) {
-        for (int j = 0; j < MAX_PARTICLES; ++j) {
-            if (!game->particles[j].active) {
-                game->particles[j].active = true;
-                game->particles[j].pos = (SDL_FPoint){x, y};
-                float angle = ((float)rand() / RAND_MAX) * 2.0f * M_PI;
-                float speed = ((float)rand() / RAND_MAX) * 100.0f + 50.0f;
-                game->particles[j].vel.x = cosf(angle) * speed;
-                game->particles[j].vel.y = sinf(angle) * speed;
-                game->particles[j].color = color;
-                game->particles[j].lifetime = PARTICLE_LIFESPAN * (0.5f + ((float)rand() / RAND_MAX) * 0.5f);
-                break;
-            }
+        int j = claim_slot(&particles->count, particles->capacity, &particles->dropped);
+        if (j < 0) {
+            particles->dropped += count - i - 1; // Las que quedaban tampoco caben
+            break;
         }
+        particles->pos_x[j] = x;
+        particles->pos_y[j] = y;
+        particles->prev_x[j] = x;
+        particles->prev_y[j] = y;
+        float angle = rng_float(&game->fx_rng) * 2.0f * M_PI;
+        float speed = rng_float(&game->fx_rng) * 100.0f + 50.0f;
+        particles->vel_x[j] = cosf(angle) * speed;
+        particles->vel_y[j] = sinf(angle) * speed;
+        particles->color[j] = color;
+        particles->lifetime[j] = PARTICLE_LIFESPAN * (0.5f + rng_float(&game->fx_rng) * 0.5f);
     }
+    PROFILE_END(PROFILE_EXPLOSION);
+}
+
+int move_particles(Game* game, float dt, int begin, int end) {
+    ParticlePool* particles = &game->particles;
+    int n = end - begin;
+    kinematics->integrate(particles->pos_x + begin, particles->pos_y + begin, particles->vel_x + begin, particles->vel_y + begin, n, dt);
+
+    // Fricción para las partículas
+    kinematics->damp(particles->vel_x + begin, particles->vel_y + begin, n, 1.0f - 1.5f * dt);
+
+    return kinematics->expire(particles->lifetime + begin, particles->pos_x + begin, particles->pos_y + begin,
+                              particles->expired + begin, n, dt, NULL);
 }
 
 void update_particles(Game* game, float dt) {
-    for (int i = 0; i < MAX_PARTICLES; ++i) {
-        if (game->particles[i].active) {
-            game->particles[i].pos.x += game->particles[i].vel.x * dt;
-            game->particles[i].pos.y += game->particles[i].vel.y * dt;
-
-            // Movimiento relativo al mundo
-            game->particles[i].pos.x -= game->ship.vel.x * dt;
-            game->particles[i].pos.y -= game->ship.vel.y * dt;
-
-            // Fricción para las partículas
-            game->particles[i].vel.x *= (1.0f - 1.5f * dt);
-            game->particles[i].vel.y *= (1.0f - 1.5f * dt);
-
-            game->particles[i].lifetime -= dt;
-            if (game->particles[i].lifetime <= 0) {
-                game->particles[i].active = false;
-            }
-        }
+    if (move_particles(game, dt, 0, game->particles.count) > 0) {
+        remove_expired_particles(&game->particles);
     }
 }
 
 void render_particles(Game* game) {
-    for (int i = 0; i < MAX_PARTICLES; ++i) {
-        if (game->particles[i].active) {
-            SDL_FColor color = game->particles[i].color;
-            // Hacer que la partícula se desvanezca
-            float alpha = (game->particles[i].lifetime / PARTICLE_LIFESPAN);
-            // SDL_SetRenderDrawColorFloat no existe. Usamos la versión de 8-bit.
-            // Para que el alpha blending funcione en primitivas, el blend mode del renderer debe ser SDL_BLENDMODE_BLEND.
-            SDL_SetRenderDrawColor(game->renderer, (Uint8)(color.r * 255), (Uint8)(color.g * 255), (Uint8)(color.b * 255), (Uint8)(alpha * 255));
-            SDL_SetRenderDrawBlendMode(game->renderer, SDL_BLENDMODE_BLEND);
-            SDL_RenderPoint(game->renderer, game->particles[i].pos.x, game->particles[i].pos.y);
-        }
+    const ParticlePool* particles = &game->particles;
+    SDL_Vertex* v = batch_quads(&game->frame.vectors, particles->count);
+    if (!v) {
+        return;
+    }
+    // Cada partícula es un quad de 1x1 píxel que se desvanece con su vida restante
+    for (int i = 0; i < particles->count; i++, v += 4) {
+        SDL_FColor color = particles->color[i];
+        color.a = particles->lifetime[i] / PARTICLE_LIFESPAN;
+        SDL_FPoint pos = interpolate_pos(game, particles->prev_x[i], particles->prev_y[i], particles->pos_x[i], particles->pos_y[i]);
+        v[0] = (SDL_Vertex){ { pos.x, pos.y }, color, { 0.0f, 0.0f } };
+        v[1] = (SDL_Vertex){ { pos.x + 1.0f, pos.y }, color, { 0.0f, 0.0f } };
+        v[2] = (SDL_Vertex){ { pos.x + 1.0f, pos.y + 1.0f }, color, { 0.0f, 0.0f } };
+        v[3] = (SDL_Vertex){ { pos.x, pos.y + 1.0f }, color, { 0.0f, 0.0f } };
     }
 }
 
+// --- Detección de Colisiones ---
+
+// Cada detector pide a la rejilla los candidatos cercanos, sólo comprueba la
+// distancia con ellos y anota los contactos en game->contacts. No cambia nada
+// del juego: las consecuencias se aplican después, en resolve_contacts.
 
-// --- Funciones Auxiliares de Colisión ---
+static void add_contact(ContactBuffer* contacts, ContactType type, int a, int b) {
+    contacts->items[contacts->count++] = (Contact){ type, a, b };
+}
 
-static void handle_bullet_asteroid_collisions(Game* game) {
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        if (!game->asteroids[i].active) continue;
+static bool ship_vulnerable(const Game* game) {
+    return game->respawn_timer <= 0 && game->shield_timer <= 0;
+}
 
-        for (int j = 0; j < MAX_BULLETS; j++) {
-            if (game->bullets[j].active) {
-                float dx = game->asteroids[i].pos.x - game->bullets[j].pos.x;
-                float dy = game->asteroids[i].pos.y - game->bullets[j].pos.y;
-                float dist_sq = dx * dx + dy * dy;
-                float radius = game->asteroids[i].size * 10.0f;
+static void detect_ship_asteroid(const Game* game, ContactBuffer* contacts) {
+    const AsteroidPool* asteroids = &game->asteroids;
+    GridQuery query;
+    if (!ship_vulnerable(game)) return;
+    begin_grid_query(&query, &game->grid, GRID_ASTEROIDS, game->ship.pos.x, game->ship.pos.y,
+                     ASTEROID_MAX_RADIUS + SHIP_SIZE * 0.5f);
+
+    for (int i = next_grid_query(&query); i >= 0; i = next_grid_query(&query)) {
+        float dx = asteroids->pos_x[i] - game->ship.pos.x;
+        float dy = asteroids->pos_y[i] - game->ship.pos.y;
+        float dist_sq = dx * dx + dy * dy; // Distancia al cuadrado
+        float radius_sum = asteroids->size[i] * 10.0f + SHIP_SIZE * 0.5f;
+        float radius_sum_sq = radius_sum * radius_sum; // Suma de radios al cuadrado
+
+        if (dist_sq < radius_sum_sq) {
+            add_contact(contacts, CONTACT_SHIP_ASTEROID, i, -1);
+            return; // Tras el primer impacto la nave es invulnerable
+        }
+    }
+}
 
-                if (dist_sq < radius * radius) {
-                    game->bullets[j].active = false;
-                    game->asteroids[i].active = false;
-                    game->score += (4 - game->asteroids[i].size) * 10;
-                    spawn_explosion(game, game->asteroids[i].pos.x, game->asteroids[i].pos.y, (SDL_FColor){1.0f, 1.0f, 1.0f, 1.0f}, 15);
+static void detect_ufo_bullet_ship(const Game* game, ContactBuffer* contacts) {
+    const BulletPool* bullets = &game->ufo_bullets;
+    GridQuery query;
+    if (!ship_vulnerable(game) || bullets->count == 0) return;
+    float ship_radius = SHIP_SIZE * 0.8f;
+    begin_grid_query(&query, &game->grid, GRID_UFO_BULLETS, game->ship.pos.x, game->ship.pos.y, ship_radius);
 
-                    // Probabilidad de soltar un power-up
-                    if (game->asteroids[i].size > 1 && (rand() % 10 == 0)) { // 10% de probabilidad
-                        spawn_powerup(game, game->asteroids[i].pos.x, game->asteroids[i].pos.y);
-                    }
+    for (int i = next_grid_query(&query); i >= 0; i = next_grid_query(&query)) {
+        float dx = bullets->pos_x[i] - game->ship.pos.x;
+        float dy = bullets->pos_y[i] - game->ship.pos.y;
+        float dist_sq = dx * dx + dy * dy;
 
-                    if (game->asteroids[i].size > 1) {
-                        create_asteroid(game, game->asteroids[i].pos.x, game->asteroids[i].pos.y, game->asteroids[i].size - 1, &game->asteroids[i].vel, &game->bullets[j].vel);
-                        create_asteroid(game, game->asteroids[i].pos.x, game->asteroids[i].pos.y, game->asteroids[i].size - 1, &game->asteroids[i].vel, &game->bullets[j].vel);
-                    }
-                }
+        if (dist_sq < ship_radius * ship_radius) {
+            add_contact(contacts, CONTACT_UFO_BULLET_SHIP, i, -1);
+            return;
+        }
+    }
+}
+
+// Cada bala sólo puede dar a un asteroide: la primera que lo toca queda
+// reservada en 'claimed' y los asteroides siguientes (y el OVNI) la ignoran
+static void detect_bullet_asteroid(const Game* game, ContactBuffer* contacts) {
+    const AsteroidPool* asteroids = &game->asteroids;
+    const BulletPool* bullets = &game->bullets;
+    GridQuery query;
+
+    if (bullets->count == 0) return; // Sin balas no hace falta consultar la rejilla
+    for (int i = 0; i < asteroids->count; i++) {
+        float radius = asteroids->size[i] * 10.0f;
+        begin_grid_query(&query, &game->grid, GRID_BULLETS, asteroids->pos_x[i], asteroids->pos_y[i], radius);
+        for (int j = next_grid_query(&query); j >= 0; j = next_grid_query(&query)) {
+            if (contacts->claimed[j]) continue; // Ya ha dado a otro asteroide
+
+            float dx = asteroids->pos_x[i] - bullets->pos_x[j];
+            float dy = asteroids->pos_y[i] - bullets->pos_y[j];
+            float dist_sq = dx * dx + dy * dy;
+
+            if (dist_sq < radius * radius) {
+                contacts->claimed[j] = 1;
+                add_contact(contacts, CONTACT_BULLET_ASTEROID, i, j);
+                break; // Este asteroide ya no existe
             }
         }
     }
 }
 
-static void handle_ship_asteroid_collisions(Game* game) {
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        if (!game->asteroids[i].active) continue;
+static void detect_bullet_ufo(const Game* game, ContactBuffer* contacts) {
+    const BulletPool* bullets = &game->bullets;
+    GridQuery query;
+    if (!game->ufo.active || bullets->count == 0) return;
+    float ufo_size_multiplier = (game->ufo.type == UFO_SMALL) ? 0.7f : 1.5f;
+    float ufo_radius = SHIP_SIZE * ufo_size_multiplier;
+    begin_grid_query(&query, &game->grid, GRID_BULLETS, game->ufo.pos.x, game->ufo.pos.y, ufo_radius);
+
+    for (int j = next_grid_query(&query); j >= 0; j = next_grid_query(&query)) {
+        if (contacts->claimed[j]) continue;
+
+        float dx_ufo = game->ufo.pos.x - bullets->pos_x[j];
+        float dy_ufo = game->ufo.pos.y - bullets->pos_y[j];
+        float dist_sq_ufo = dx_ufo * dx_ufo + dy_ufo * dy_ufo;
+
+        if (dist_sq_ufo < ufo_radius * ufo_radius) {
+            contacts->claimed[j] = 1;
+            add_contact(contacts, CONTACT_BULLET_UFO, -1, j);
+            return; // El OVNI ya no existe
+        }
+    }
+}
+
+static void detect_ship_powerup(const Game* game, ContactBuffer* contacts) {
+    const PowerUpPool* powerups = &game->powerups;
+    GridQuery query;
+    if (game->respawn_timer > 0 || powerups->count == 0) return;
+    float radius_sum = POWERUP_SIZE + SHIP_SIZE * 0.5f;
+    begin_grid_query(&query, &game->grid, GRID_POWERUPS, game->ship.pos.x, game->ship.pos.y, radius_sum);
 
-        if (game->respawn_timer <= 0 && game->shield_timer <= 0) {
-            float dx = game->asteroids[i].pos.x - (SCREEN_WIDTH / 2.0f);
-            float dy = game->asteroids[i].pos.y - (SCREEN_HEIGHT / 2.0f);
-            float dist_sq = dx * dx + dy * dy; // Distancia al cuadrado
-            float radius_sum = game->asteroids[i].size * 10.0f + SHIP_SIZE * 0.5f;
-            float radius_sum_sq = radius_sum * radius_sum; // Suma de radios al cuadrado
+    for (int i = next_grid_query(&query); i >= 0; i = next_grid_query(&query)) {
+        float dx = powerups->pos_x[i] - game->ship.pos.x;
+        float dy = powerups->pos_y[i] - game->ship.pos.y;
+        float dist_sq = dx * dx + dy * dy;
 
-            if (dist_sq < radius_sum_sq) {
-                spawn_explosion(game, game->asteroids[i].pos.x, game->asteroids[i].pos.y, (SDL_FColor){1.0f, 0.2f, 0.2f, 1.0f}, 30);
-                game->lives--;
-                game->shake_timer = 0.5f; // Duración de la sacudida en segundos
-                game->shake_intensity = 10.0f; // Intensidad inicial en píxeles
-                if (game->lives <= 0) {
-                    game->state = GAME_STATE_GAMEOVER;
-                } else {
-                    reset_ship(game, true);
-                }
-            }
+        if (dist_sq < radius_sum * radius_sum) {
+            add_contact(contacts, CONTACT_SHIP_POWERUP, i, -1);
         }
     }
 }
 
-static void handle_bullet_ufo_collisions(Game* game) {
-    if (game->ufo.active) {
-        for (int j = 0; j < MAX_BULLETS; j++) {
-            if (game->bullets[j].active) {
-                float dx_ufo = game->ufo.pos.x - game->bullets[j].pos.x;
-                float dy_ufo = game->ufo.pos.y - game->bullets[j].pos.y;
-                float dist_sq_ufo = dx_ufo * dx_ufo + dy_ufo * dy_ufo;
-                float ufo_size_multiplier = (game->ufo.type == UFO_SMALL) ? 0.7f : 1.5f;
-                float ufo_radius = SHIP_SIZE * ufo_size_multiplier;
-
-                if (dist_sq_ufo < ufo_radius * ufo_radius) {
-                    game->bullets[j].active = false;
-                    game->ufo.active = false;
-                    game->ufo.spawn_timer = UFO_SPAWN_TIME;
-                    game->score += (game->ufo.type == UFO_SMALL) ? 500 : 200;
-                    spawn_explosion(game, game->ufo.pos.x, game->ufo.pos.y, (SDL_FColor){0.8f, 0.2f, 0.8f, 1.0f}, 25);
-                }
-            }
-        }
+// --- Resolución de Colisiones ---
+
+// Las entidades destruidas se marcan en 'expired' en vez de eliminarse: los
+// índices de los contactos tienen que seguir valiendo hasta el final de
+// check_collisions, que es donde se compactan las pools.
+
+static void hit_ship(Game* game, float x, float y) {
+    spawn_explosion(game, x, y, (SDL_FColor){1.0f, 0.2f, 0.2f, 1.0f}, 30);
+    game->lives--;
+    game->shake_timer = 0.5f; // Duración de la sacudida en segundos
+    game->shake_intensity = 10.0f; // Intensidad inicial en píxeles
+    if (game->lives <= 0) {
+        game->state = GAME_STATE_GAMEOVER;
+    } else {
+        reset_ship(game, true);
     }
 }
 
-static void handle_ufo_bullet_ship_collisions(Game* game) {
-    if (game->respawn_timer <= 0 && game->shield_timer <= 0) {
-        for (int i = 0; i < MAX_BULLETS; i++) {
-            if (game->ufo_bullets[i].active) {
-                float dx = game->ufo_bullets[i].pos.x - (SCREEN_WIDTH / 2.0f);
-                float dy = game->ufo_bullets[i].pos.y - (SCREEN_HEIGHT / 2.0f);
-                float dist_sq = dx * dx + dy * dy;
-                float ship_radius = SHIP_SIZE * 0.8f;
-
-                if (dist_sq < ship_radius * ship_radius) {
-                    spawn_explosion(game, game->ufo_bullets[i].pos.x, game->ufo_bullets[i].pos.y, (SDL_FColor){1.0f, 0.2f, 0.2f, 1.0f}, 30);
-                    game->ufo_bullets[i].active = false;
-                    game->lives--;
-                    game->shake_timer = 0.5f;
-                    game->shake_intensity = 10.0f;
-                    if (game->lives <= 0) {
-                        game->state = GAME_STATE_GAMEOVER;
-                    } else {
-                        reset_ship(game, true);
-                    }
+// Aplica los contactos en el orden en que se detectaron y devuelve cuántos
+// asteroides se han roto (en asteroids.splits)
+static int resolve_contacts(Game* game) {
+    const ContactBuffer* contacts = &game->contacts;
+    AsteroidPool* asteroids = &game->asteroids;
+    BulletPool* bullets = &game->bullets;
+    int split_count = 0;
+
+    for (int c = 0; c < contacts->count; c++) {
+        // Si la nave se ha quedado sin vidas, lo demás ya no cuenta
+        if (game->state != GAME_STATE_PLAYING) break;
+
+        const Contact* contact = &contacts->items[c];
+        int i = contact->a;
+        int j = contact->b;
+        switch (contact->type) {
+            case CONTACT_SHIP_ASTEROID:
+                hit_ship(game, asteroids->pos_x[i], asteroids->pos_y[i]);
+                break;
+            case CONTACT_UFO_BULLET_SHIP:
+                // Un asteroide puede haber dado antes a la nave en este mismo paso
+                if (!ship_vulnerable(game)) break;
+                game->ufo_bullets.expired[i] = 1;
+                hit_ship(game, game->ufo_bullets.pos_x[i], game->ufo_bullets.pos_y[i]);
+                break;
+            case CONTACT_BULLET_ASTEROID:
+                bullets->expired[j] = 1;
+                asteroids->expired[i] = 1;
+                game->score += (4 - asteroids->size[i]) * 10;
+                spawn_explosion(game, asteroids->pos_x[i], asteroids->pos_y[i], (SDL_FColor){1.0f, 1.0f, 1.0f, 1.0f}, 15);
+                asteroids->splits[split_count++] = (AsteroidSplit){
+                    asteroids->pos_x[i], asteroids->pos_y[i], asteroids->size[i],
+                    { asteroids->vel_x[i], asteroids->vel_y[i] },
+                    { bullets->vel_x[j], bullets->vel_y[j] },
+                };
+                break;
+            case CONTACT_BULLET_UFO:
+                bullets->expired[j] = 1;
+                game->ufo.active = false;
+                game->ufo.spawn_timer = UFO_SPAWN_TIME;
+                game->score += (game->ufo.type == UFO_SMALL) ? 500 : 200;
+                spawn_explosion(game, game->ufo.pos.x, game->ufo.pos.y, (SDL_FColor){0.8f, 0.2f, 0.8f, 1.0f}, 25);
+                break;
+            case CONTACT_SHIP_POWERUP:
+                if (game->respawn_timer > 0) break; // La nave acaba de perder una vida
+                if (game->powerups.type[i] == POWERUP_SHIELD) {
+                    game->shield_timer = SHIELD_DURATION;
+                } else if (game->powerups.type[i] == POWERUP_TRIPLE_SHOT) {
+                    game->triple_shot_timer = TRIPLE_SHOT_DURATION;
                 }
-            }
+                game->powerups.expired[i] = 1;
+                break;
         }
     }
+    return split_count;
 }
 
-static void handle_ship_powerup_collisions(Game* game) {
-    if (game->respawn_timer <= 0) {
-        for (int i = 0; i < MAX_POWERUPS; i++) {
-            if (game->powerups[i].active) {
-                float dx = game->powerups[i].pos.x - (SCREEN_WIDTH / 2.0f);
-                float dy = game->powerups[i].pos.y - (SCREEN_HEIGHT / 2.0f);
-                float dist_sq = dx * dx + dy * dy;
-                float radius_sum = POWERUP_SIZE + SHIP_SIZE * 0.5f;
+// Crea los power-ups y fragmentos de los asteroides rotos en este paso
+static void split_asteroids(Game* game, int count) {
+    for (int s = 0; s < count; s++) {
+        const AsteroidSplit* split = &game->asteroids.splits[s];
 
-                if (dist_sq < radius_sum * radius_sum) {
-                    game->powerups[i].active = false;
-                    if (game->powerups[i].type == POWERUP_SHIELD) {
-                        game->shield_timer = SHIELD_DURATION;
-                    } else if (game->powerups[i].type == POWERUP_TRIPLE_SHOT) {
-                        game->triple_shot_timer = TRIPLE_SHOT_DURATION;
-                    }
-                }
-            }
+        // Probabilidad de soltar un power-up
+        if (split->size > 1 && (rng_int(&game->sim_rng, 10) == 0)) { // 10% de probabilidad
+            spawn_powerup(game, split->x, split->y);
+        }
+
+        if (split->size > 1) {
+            create_asteroid(game, split->x, split->y, split->size - 1, &split->parent_vel, &split->bullet_vel);
+            create_asteroid(game, split->x, split->y, split->size - 1, &split->parent_vel, &split->bullet_vel);
         }
     }
 }
@@ -767,15 +1330,27 @@ static void handle_ship_powerup_collisions(Game* game) {
 // --- Colisiones ---
 
 void check_collisions(Game* game) {
-    // Las colisiones que destruyen la nave deben ir primero para evitar
-    // que la nave destruida interactúe con otras cosas en el mismo frame.
-    handle_ship_asteroid_collisions(game);
-    if (game->state != GAME_STATE_PLAYING) return; // Si el juego terminó, no seguir.
-
-    handle_ufo_bullet_ship_collisions(game);
-    if (game->state != GAME_STATE_PLAYING) return;
-
-    handle_bullet_asteroid_collisions(game);
-    handle_bullet_ufo_collisions(game);
-    handle_ship_powerup_collisions(game);
-}
\ No newline at end of file
+    ContactBuffer* contacts = &game->contacts;
+
+    build_grid(game);
+
+    // Detección: sólo lee posiciones y estado. El orden de las pasadas es el
+    // de resolución: lo que destruye la nave va primero para que una nave
+    // destruida no interactúe con otras cosas en el mismo paso.
+    contacts->count = 0;
+    SDL_memset(contacts->claimed, 0, (size_t)game->bullets.count);
+    detect_ship_asteroid(game, contacts);
+    detect_ufo_bullet_ship(game, contacts);
+    detect_bullet_asteroid(game, contacts);
+    detect_bullet_ufo(game, contacts);
+    detect_ship_powerup(game, contacts);
+
+    int split_count = resolve_contacts(game);
+
+    // Aquí dejan de usarse los índices de los contactos: ya se puede compactar
+    remove_expired_bullets(&game->bullets);
+    remove_expired_bullets(&game->ufo_bullets);
+    remove_expired_asteroids(&game->asteroids);
+    remove_expired_powerups(&game->powerups);
+    split_asteroids(game, split_count);
+}
@@ -5,6 +5,24 @@
 
 // --- Prototipos de Funciones de Entidades ---
 
+// Pools
+bool init_entity_pools(Game* game, const PoolCapacities* capacities);
+void free_entity_pools(Game* game);
+void copy_entity_pools(Game* dst, const Game* src); // Ambos con las mismas capacidades
+// Como copy_entity_pools, pero sólo el tramo vivo de lo que usan los render_*;
+// las estrellas fijas tienen que haberse copiado antes con copy_entity_pools
+void snapshot_entity_pools(Game* dst, const Game* src);
+void log_pool_usage(const Game* game);
+void clear_entities(Game* game);
+
+// Interpolación entre pasos de simulación
+void store_previous_state(Game* game);
+// Fija game->camera para dibujar el fotograma (la vista sigue a la nave)
+void update_camera(Game* game);
+// Esquina superior izquierda de la vista en el paso actual, sin interpolar: la
+// simulación la usa para el wrap, la caducidad, las apariciones y la rejilla
+SDL_FPoint view_origin(const Game* game);
+
 // Nave
 void reset_ship(Game* game, bool invincible);
 void update_ship(Game* game, float dt);
@@ -52,4 +70,14 @@ void render_particles(Game* game);
 // Colisiones
 void check_collisions(Game* game);
 
+// Por tramos [begin, end) de la pool, para repartir las grandes entre hilos
+// (ver update_entities en game.c). Mueven y marcan en 'expired' lo que caduca,
+// sin compactar; devuelven cuántas entidades del tramo han caducado.
+// update_bullets/asteroids/particles equivalen a la pool entera y remove_expired_*.
+int move_bullets(Game* game, float dt, int begin, int end);
+void move_asteroids(Game* game, float dt, int begin, int end);
+int move_particles(Game* game, float dt, int begin, int end);
+void remove_expired_bullets(BulletPool* bullets);
+void remove_expired_particles(ParticlePool* particles);
+
 #endif // ENTITIES_H
\ No newline at end of file
@@ -1,12 +1,11 @@
 #include "game.h"
 #include "entities.h"
 #include "utils.h"
-#include <stdio.h>
-#include <stdlib.h>
-#include <time.h>
-
-// --- Prototipos de Funciones Internas (solo para funciones definidas en este archivo y no en game.h) ---
-int load_highscore(void);
+#include "render.h"
+#include "replay.h"
+#include "scores.h"
+#include "profiler.h"
+#include "jobs.h"
 
 bool init_sdl(Game* game) {
     if (!SDL_Init(SDL_INIT_VIDEO)) {
@@ -31,11 +30,15 @@ bool init_sdl(Game* game) {
         return false;
     }
     SDL_SetRenderVSync(game->renderer, 1);
+    // Se fija una sola vez: las partículas se desvanecen con el alpha de sus vértices
+    SDL_SetRenderDrawBlendMode(game->renderer, SDL_BLENDMODE_BLEND);
 
-    game->font = TTF_OpenFont("Press_Start_2P.ttf", 20);
+    game->font = TTF_OpenFont("Press_Start_2P.ttf", FONT_SIZE);
     if (!game->font) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo cargar la fuente 'Press_Start_2P.ttf': %s", SDL_GetError());
         // No es fatal, el juego puede continuar sin texto.
+    } else if (!init_text_atlas(game)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo crear el atlas de texto: %s", SDL_GetError());
     }
 
     return true;
@@ -54,110 +57,289 @@ void start_new_game(Game* game) {
     game->difficulty_factor = 1.0f;
     game->shake_timer = 0.0f;
     game->shake_intensity = 0.0f;
+    game->ship.pos = (SDL_FPoint){SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+    game->ship.prev_pos = game->ship.pos;
     reset_ship(game, false);
 
     game->ufo.active = false;
     game->ufo.spawn_timer = UFO_SPAWN_TIME;
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        game->bullets[i].active = false;
-        game->ufo_bullets[i].active = false;
-    }
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        game->asteroids[i].active = false;
-    }
-    for (int i = 0; i < MAX_POWERUPS; i++) {
-        game->powerups[i].active = false;
-    }
-
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        game->particles[i].active = false;
-    }
+    clear_entities(game);
 }
 
 void init_game_state(Game* game) {
-    game->highscore = load_highscore();
+    load_leaderboard(&game->leaderboard);
+    game->highscore = game->leaderboard.count > 0 ? game->leaderboard.entries[0].score : 0;
     game->fullscreen = false;
     game->state = GAME_STATE_MENU;
     game->menu_selection = 0;
     init_stars(game);
 }
 
+// Estado de las teclas que se mantienen pulsadas; update_ship sólo lee game->input
+void poll_held_keys(InputState* input) {
+    const bool* state = SDL_GetKeyboardState(NULL);
+    input->thrust = state[SDL_SCANCODE_UP] || state[SDL_SCANCODE_W];
+    input->turn_left = state[SDL_SCANCODE_LEFT] || state[SDL_SCANCODE_A];
+    input->turn_right = state[SDL_SCANCODE_RIGHT] || state[SDL_SCANCODE_D];
+}
+
+// Cierre y teclas globales (independientes del estado)
+void handle_window_event(Game* game, const SDL_Event* event) {
+    if (event->type == SDL_EVENT_QUIT) {
+        game->running = false;
+    }
+    if (event->type == SDL_EVENT_KEY_DOWN) {
+        if (event->key.scancode == SDL_SCANCODE_F11) {
+            game->fullscreen = !game->fullscreen;
+            SDL_SetWindowFullscreen(game->window, game->fullscreen);
+        }
+        if (event->key.scancode == SDL_SCANCODE_F3) {
+            profile_toggle_overlay();
+        }
+        if (event->key.scancode == SDL_SCANCODE_F4) {
+            write_trace(game->config.trace_path ? game->config.trace_path : PROFILE_TRACE_FILE);
+        }
+        if (event->key.scancode == SDL_SCANCODE_F5) {
+            write_render_list(&game->frame, RENDER_DUMP_FILE);
+        }
+    }
+}
+
+// Manejo de eventos por estado
+void handle_game_event(Game* game, const SDL_Event* event) {
+    if (event->type != SDL_EVENT_KEY_DOWN) {
+        return;
+    }
+    SDL_Scancode key = event->key.scancode;
+    switch (game->state) {
+        case GAME_STATE_MENU:
+            if (key == SDL_SCANCODE_UP) game->menu_selection = 0;
+            if (key == SDL_SCANCODE_DOWN) game->menu_selection = 1;
+            if (key == SDL_SCANCODE_RETURN || key == SDL_SCANCODE_KP_ENTER) {
+                if (game->menu_selection == 0) { // Jugar
+                    game->input.new_game = true;
+                } else { // Salir
+                    game->running = false;
+                }
+            }
+            break;
+        case GAME_STATE_PLAYING:
+            if (key == SDL_SCANCODE_SPACE) game->input.fire = true;
+            if (key == SDL_SCANCODE_LSHIFT) game->input.hyperspace = true;
+            if (key == SDL_SCANCODE_P || key == SDL_SCANCODE_ESCAPE) game->state = GAME_STATE_PAUSED;
+            break;
+        case GAME_STATE_PAUSED:
+            if (key == SDL_SCANCODE_P || key == SDL_SCANCODE_ESCAPE) game->state = GAME_STATE_PLAYING;
+            break;
+        case GAME_STATE_GAMEOVER:
+            if (key == SDL_SCANCODE_SPACE) {
+                game->state = GAME_STATE_MENU;
+            }
+            break;
+    }
+}
+
 void handle_events(Game* game) {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
-        if (event.type == SDL_EVENT_QUIT) {
-            game->running = false;
-        }
+        handle_window_event(game, &event);
+        handle_game_event(game, &event);
+    }
 
-        // Manejo de eventos globales (independientes del estado)
-        if (event.type == SDL_EVENT_KEY_DOWN) {
-            if (event.key.scancode == SDL_SCANCODE_F11) {
-                game->fullscreen = !game->fullscreen;
-                SDL_SetWindowFullscreen(game->window, game->fullscreen);
-            }
-        }
+    poll_held_keys(&game->input);
+}
 
-        // Manejo de eventos por estado
-        switch (game->state) {
-            case GAME_STATE_MENU:
-                if (event.type == SDL_EVENT_KEY_DOWN) {
-                    if (event.key.scancode == SDL_SCANCODE_UP) game->menu_selection = 0;
-                    if (event.key.scancode == SDL_SCANCODE_DOWN) game->menu_selection = 1;
-                    if (event.key.scancode == SDL_SCANCODE_RETURN || event.key.scancode == SDL_SCANCODE_KP_ENTER) {
-                        if (game->menu_selection == 0) { // Jugar
-                            start_new_game(game);
-                            start_level(game);
-                        } else { // Salir
-                            game->running = false;
-                        }
-                    }
-                }
-                break;
-            case GAME_STATE_PLAYING:
-                if (event.type == SDL_EVENT_KEY_DOWN) {
-                    if (event.key.scancode == SDL_SCANCODE_SPACE && game->respawn_timer <= 0) fire_bullet(game);
-                    if (event.key.scancode == SDL_SCANCODE_LSHIFT) activate_hyperspace(game);
-                    if (event.key.scancode == SDL_SCANCODE_P || event.key.scancode == SDL_SCANCODE_ESCAPE) game->state = GAME_STATE_PAUSED;
-                }
-                break;
-            case GAME_STATE_PAUSED:
-                if (event.type == SDL_EVENT_KEY_DOWN) {
-                    if (event.key.scancode == SDL_SCANCODE_P || event.key.scancode == SDL_SCANCODE_ESCAPE) game->state = GAME_STATE_PLAYING;
-                }
-                break;
-            case GAME_STATE_GAMEOVER:
-                if (event.type == SDL_EVENT_KEY_DOWN && event.key.scancode == SDL_SCANCODE_SPACE) {
-                    game->state = GAME_STATE_MENU;
-                }
-                break;
+// --- Paso de las Entidades ---
+// Cada pool sólo la toca su update_* y todas leen la nave, que ya no se
+// mueve en este paso, así que pueden ir a la vez. Las pools grandes se
+// reparten por tramos entre los hilos (ver jobs.h); mientras, el hilo
+// principal hace las pequeñas y luego ayuda con los tramos que queden.
+// Compactar cambia los índices, así que va después, en el orden de siempre:
+// el resultado es el mismo con cualquier número de hilos.
+
+typedef struct {
+    Game* game;
+    float dt;
+    SDL_AtomicInt bullets_expired;
+    SDL_AtomicInt particles_expired;
+} EntityStep;
+
+static void bullets_job(void* data, int begin, int end) {
+    EntityStep* step = data;
+    SDL_AddAtomicInt(&step->bullets_expired, move_bullets(step->game, step->dt, begin, end));
+}
+
+static void asteroids_job(void* data, int begin, int end) {
+    EntityStep* step = data;
+    move_asteroids(step->game, step->dt, begin, end);
+}
+
+static void particles_job(void* data, int begin, int end) {
+    EntityStep* step = data;
+    SDL_AddAtomicInt(&step->particles_expired, move_particles(step->game, step->dt, begin, end));
+}
+
+static void update_entities(Game* game, float dt) {
+    EntityStep step = { .game = game, .dt = dt };
+    JobGroup group = {0};
+
+    PROFILE_BEGIN(PROFILE_UPDATE_BULLETS);
+    run_chunked(&group, bullets_job, &step, game->bullets.count, JOB_CHUNK_SIZE);
+    PROFILE_END(PROFILE_UPDATE_BULLETS);
+    PROFILE_BEGIN(PROFILE_UPDATE_ASTEROIDS);
+    run_chunked(&group, asteroids_job, &step, game->asteroids.count, JOB_CHUNK_SIZE);
+    PROFILE_END(PROFILE_UPDATE_ASTEROIDS);
+    PROFILE_BEGIN(PROFILE_UPDATE_PARTICLES);
+    run_chunked(&group, particles_job, &step, game->particles.count, JOB_CHUNK_SIZE);
+    PROFILE_END(PROFILE_UPDATE_PARTICLES);
+
+    PROFILE_BEGIN(PROFILE_UPDATE_STARS);
+    update_stars(game, dt);
+    PROFILE_END(PROFILE_UPDATE_STARS);
+    PROFILE_BEGIN(PROFILE_UPDATE_UFO);
+    update_ufo(game, dt); // Dispara a la pool de balas del OVNI: va antes que ellas
+    PROFILE_END(PROFILE_UPDATE_UFO);
+    PROFILE_BEGIN(PROFILE_UPDATE_UFO_BULLETS);
+    update_ufo_bullets(game, dt);
+    PROFILE_END(PROFILE_UPDATE_UFO_BULLETS);
+    PROFILE_BEGIN(PROFILE_UPDATE_POWERUPS);
+    update_powerups(game, dt);
+    PROFILE_END(PROFILE_UPDATE_POWERUPS);
+
+    PROFILE_BEGIN(PROFILE_UPDATE_JOIN);
+    wait_jobs(&group);
+    PROFILE_END(PROFILE_UPDATE_JOIN);
+
+    if (SDL_GetAtomicInt(&step.bullets_expired) > 0) {
+        remove_expired_bullets(&game->bullets);
+    }
+    if (SDL_GetAtomicInt(&step.particles_expired) > 0) {
+        remove_expired_particles(&game->particles);
+    }
+}
+
+void update_playing(Game* game, float dt) {
+    // Pulsaciones recibidas desde el paso anterior
+    if (game->input.fire && game->respawn_timer <= 0) {
+        fire_bullet(game);
+    }
+    if (game->input.hyperspace) {
+        activate_hyperspace(game);
+    }
+    game->input.fire = false;
+    game->input.hyperspace = false;
+
+    // Aumentar la dificultad con el tiempo, con un límite
+    if (game->score > game->highscore) {
+        game->highscore = game->score;
+    }
+
+    // Aumentar la dificultad con el tiempo, con un límite
+    game->difficulty_factor += 0.002f * dt; // Aumenta un 0.12 por minuto
+    if (game->difficulty_factor > 3.0f) {
+        game->difficulty_factor = 3.0f; // Límite para no hacerlo imposible
+    }
+
+    // --- Actualizar Nave ---
+    if (game->respawn_timer > 0) {
+        game->respawn_timer -= dt;
+    }
+    PROFILE_BEGIN(PROFILE_UPDATE_SHIP);
+    update_ship(game, dt);
+    PROFILE_END(PROFILE_UPDATE_SHIP);
+
+    update_hyperspace(game, dt);
+
+    // Actualizar timers de power-ups
+    if (game->shield_timer > 0) {
+        game->shield_timer -= dt;
+    }
+    if (game->triple_shot_timer > 0) {
+        game->triple_shot_timer -= dt;
+    }
+
+    // Actualizar screen shake
+    if (game->shake_timer > 0) {
+        game->shake_timer -= dt;
+        if (game->shake_timer <= 0) {
+            game->shake_timer = 0.0f;
+            game->shake_intensity = 0.0f;
         }
     }
+
+    update_entities(game, dt);
+
+    PROFILE_BEGIN(PROFILE_COLLISIONS);
+    check_collisions(game);
+    PROFILE_END(PROFILE_COLLISIONS);
+
+    bool level_cleared = game->asteroids.count == 0;
+
+    if (level_cleared && game->state == GAME_STATE_PLAYING) {
+        start_level(game);
+        reset_ship(game, false);
+    }
 }
 
-int load_highscore(void) {
-    FILE* file = fopen("highscore.txt", "r");
-    if (!file) {
-        return 0;
+// Guarda la partida que acaba de terminar en el historial y, si entra, en la tabla
+static void submit_score(Game* game) {
+    ScoreEntry entry = { .score = game->score, .level = game->level };
+    if (!SDL_GetCurrentTime(&entry.date)) {
+        entry.date = 0;
     }
-    int score = 0;
-    if (fscanf(file, "%d", &score) != 1) {
-        score = 0;
+    SDL_strlcpy(entry.name, game->config.player_name, sizeof(entry.name));
+    if (game->recording.file) {
+        SDL_strlcpy(entry.replay, game->config.record_path, sizeof(entry.replay));
+        entry.replay_game = game->recording.games;
     }
-    fclose(file);
-    return score;
+    insert_score(&game->leaderboard, &entry);
+    save_score_async(&game->leaderboard, &entry);
 }
 
-void save_highscore(int score) {
-    FILE* file = fopen("highscore.txt", "w");
-    if (!file) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo guardar el highscore.");
-        return;
+void update_game(Game* game, float dt) {
+    store_previous_state(game);
+
+    if (game->input.new_game) {
+        start_new_game(game);
+        start_level(game);
+    }
+    if (game->state != GAME_STATE_PLAYING) {
+        // Las pulsaciones sólo cuentan en los pasos que se juegan
+        game->input.fire = false;
+        game->input.hyperspace = false;
+    }
+    if (game->recording.file) {
+        record_tick(game);
+    }
+    game->input.new_game = false;
+
+    // Las estrellas se mueven en el menú para dar un efecto dinámico
+    if (game->state == GAME_STATE_MENU) {
+        update_stars(game, dt);
+    }
+
+    if (game->state == GAME_STATE_PLAYING) {
+        update_playing(game, dt);
+        // Una sola vez, en el paso en que acaba la partida, y sin esperar al disco
+        if (game->state == GAME_STATE_GAMEOVER) {
+            PROFILE_BEGIN(PROFILE_SUBMIT_SCORE);
+            submit_score(game);
+            PROFILE_END(PROFILE_SUBMIT_SCORE);
+        }
     }
-    fprintf(file, "%d", score);
-    fclose(file);
 }
 
 void cleanup(Game* game) {
+    stop_recording(game);
+    shutdown_leaderboard_saver();
+    shutdown_jobs();
+    log_pool_usage(game);
+    free_entity_pools(game);
+    SDL_Log("Caché de texto: %llu aciertos, %llu fallos, %llu desalojos",
+            (unsigned long long)game->text_cache.hits, (unsigned long long)game->text_cache.misses,
+            (unsigned long long)game->text_cache.evictions);
+    destroy_text_atlas(game);
+    destroy_render_list(&game->frame);
     TTF_CloseFont(game->font);
     SDL_DestroyRenderer(game->renderer);
     SDL_DestroyWindow(game->window);
@@ -18,29 +18,69 @@ typedef enum {
 } GameState;
 // --- Estructuras de Datos ---
 
+// Todas las posiciones son coordenadas del mundo. La vista (SCREEN_WIDTH x
+// SCREEN_HEIGHT) está centrada en la nave: la simulación sólo mueve la nave y
+// el dibujado resta la cámara. El wrap y la caducidad por salir de la pantalla
+// se miden respecto a la vista.
 typedef struct {
     SDL_FPoint pos;
+    SDL_FPoint prev_pos;
     SDL_FPoint vel;
     float angle;
+    float prev_angle;
     bool accelerating;
 } Ship;
 
+// Las pools de entidades se guardan como estructura de arrays (SoA): cada
+// campo en su propio array contiguo, de modo que los bucles de actualización
+// sólo recorren los campos que usan. Las entidades vivas están empaquetadas en
+// los índices [0, count): se crean al final y al morir se sustituyen por la
+// última (swap-remove), así que los huecos libres son siempre [count, capacity).
+// La capacidad se elige al arrancar y todos los arrays salen de un único bloque
+// (ver init_entity_pools). 'dropped' cuenta las entidades que no se pudieron
+// crear por tener la pool llena.
+
+// Balas (del jugador o del OVNI)
 typedef struct {
-    SDL_FPoint pos;
-    SDL_FPoint vel;
-    float lifetime;
-    bool active;
-} Bullet;
+    float* pos_x;
+    float* pos_y;
+    float* prev_x; // Posición en el paso anterior (para interpolar)
+    float* prev_y;
+    float* vel_x;
+    float* vel_y;
+    float* lifetime;
+    Uint8* expired; // Marca temporal de update_* y check_collisions: 1 = eliminar
+    int capacity;
+    int count;
+    Uint64 dropped;
+} BulletPool;
 
+// Asteroide roto por una bala; sus fragmentos se crean al final de check_collisions
 typedef struct {
-    SDL_FPoint pos;
-    SDL_FPoint vel;
-    int size; // 3 = grande, 2 = mediano, 1 = pequeño
-    float angle;
-    float rotation_speed;
-    bool active;
-    float vert_offsets[ASTEROID_MAX_VERTS];
-} Asteroid;
+    float x, y;
+    int size;
+    SDL_FPoint parent_vel;
+    SDL_FPoint bullet_vel;
+} AsteroidSplit;
+
+typedef struct {
+    float* pos_x;
+    float* pos_y;
+    float* prev_x;
+    float* prev_y;
+    float* vel_x;
+    float* vel_y;
+    float* angle;
+    float* prev_angle;
+    float* rotation_speed;
+    int* size; // 3 = grande, 2 = mediano, 1 = pequeño
+    SDL_FPoint (*outline)[ASTEROID_MAX_VERTS]; // Contorno sin rotar respecto al centro, fijado al crearlo
+    Uint8* expired; // Marca temporal de check_collisions: 1 = eliminar
+    AsteroidSplit* splits; // Asteroides rotos en el paso actual (check_collisions)
+    int capacity;
+    int count;
+    Uint64 dropped;
+} AsteroidPool;
 
 typedef enum {
     UFO_LARGE,
@@ -49,6 +89,7 @@ typedef enum {
 
 typedef struct {
     SDL_FPoint pos;
+    SDL_FPoint prev_pos;
     SDL_FPoint vel;
     bool active;
     float spawn_timer;
@@ -61,47 +102,297 @@ typedef enum {
     POWERUP_TRIPLE_SHOT
 } PowerUpType;
 
+// Los power-ups no se mueven por sí mismos: sólo se desplazan con el mundo
 typedef struct {
-    SDL_FPoint pos;
-    SDL_FPoint vel;
-    PowerUpType type;
-    bool active;
-    float lifetime;
-} PowerUp;
+    float* pos_x;
+    float* pos_y;
+    float* prev_x;
+    float* prev_y;
+    float* lifetime;
+    PowerUpType* type;
+    Uint8* expired; // Marca temporal de check_collisions: 1 = eliminar
+    int capacity;
+    int count;
+    Uint64 dropped;
+} PowerUpPool;
 
+// Todas las estrellas están siempre activas (count == capacity). Van agrupadas
+// por capa de profundidad (0=lejos, lento; 1=medio; 2=cerca, rápido): la capa k
+// ocupa [layer_start[k], layer_start[k + 1]). Son un fondo, no parte del mundo:
+// su posición en pantalla es la fija menos el desplazamiento de su capa.
 typedef struct {
-    SDL_FPoint pos;
-    // Capa de profundidad: 0=lejos (lento), 1=medio, 2=cerca (rápido)
-    int layer;
-} Star;
+    float* pos_x; // Fijas, en [0, SCREEN_WIDTH) x [0, SCREEN_HEIGHT)
+    float* pos_y;
+    float* parallax;    // Fracción del movimiento de la nave que sigue la estrella, según su capa
+    SDL_FPoint step;    // Desplazamiento de la nave en el último paso, para interpolar
+    SDL_FPoint offset[STAR_LAYERS]; // Desplazamiento acumulado de cada capa, módulo la pantalla
+    int layer_start[STAR_LAYERS + 1];
+    int capacity;
+    int count;
+} StarPool;
 
 typedef struct {
-    SDL_FPoint pos;
-    SDL_FPoint vel;
-    SDL_FColor color;
-    float lifetime;
-    bool active;
-} Particle;
+    float* pos_x;
+    float* pos_y;
+    float* prev_x;
+    float* prev_y;
+    float* vel_x;
+    float* vel_y;
+    float* lifetime;
+    SDL_FColor* color;
+    Uint8* expired; // Máscara temporal de update_particles: 1 = eliminar
+    int capacity;
+    int count;
+    Uint64 dropped;
+} ParticlePool;
+
+// Rejilla de colisiones: cada celda de cada capa es una lista enlazada de
+// índices de la pool. head[l][c] es la primera entidad de la capa l en la celda
+// c (-1 si está vacía) y next[first[l] + i] la siguiente a la entidad i.
+typedef enum {
+    GRID_ASTEROIDS,
+    GRID_BULLETS,
+    GRID_UFO_BULLETS,
+    GRID_POWERUPS,
+    GRID_LAYER_COUNT
+} GridLayer;
+
+typedef struct {
+    SDL_FPoint origin; // Esquina de la vista (en el mundo) al construirla
+    int head[GRID_LAYER_COUNT][GRID_CELLS];
+    int first[GRID_LAYER_COUNT];
+    int* next; // Una entrada por hueco de las pools de la rejilla
+} SpatialGrid;
+
+// Contactos de un paso: check_collisions primero los detecta sin tocar el
+// juego y después los resuelve en el orden del búfer, que es el de la lista.
+typedef enum {
+    CONTACT_SHIP_ASTEROID,   // a = asteroide
+    CONTACT_UFO_BULLET_SHIP, // a = bala del OVNI
+    CONTACT_BULLET_ASTEROID, // a = asteroide, b = bala
+    CONTACT_BULLET_UFO,      // b = bala
+    CONTACT_SHIP_POWERUP     // a = power-up
+} ContactType;
+
+typedef struct {
+    ContactType type;
+    int a;
+    int b;
+} Contact;
+
+// Como mucho un contacto por asteroide y por power-up más uno de cada tipo
+// con la nave o el OVNI, así que el búfer nunca se llena
+typedef struct {
+    Contact* items;
+    Uint8* claimed; // Balas que ya tienen contacto en la detección en curso
+    int capacity;
+    int count;
+} ContactBuffer;
+
+// Capacidad de cada pool, elegida al arrancar (--max-bullets, --max-asteroids, ...)
+typedef struct {
+    int bullets; // Cada una de las dos pools de balas
+    int asteroids;
+    int powerups;
+    int stars;
+    int particles;
+} PoolCapacities;
+
+// Lote de segmentos y triángulos del fotograma (ver batch.h). Los arrays crecen
+// según haga falta y se reutilizan de un fotograma a otro.
+typedef struct {
+    SDL_Vertex* vertices;
+    int* indices;
+    int vertex_count;
+    int index_count;
+    int vertex_capacity;
+    int index_capacity;
+} VectorBatch;
+
+// Orden de la lista de dibujo (ver render.h)
+typedef enum {
+    RENDER_CLEAR,
+    RENDER_VIEWPORT, // Desplaza el área de dibujo (temblor de pantalla); (0, 0) la devuelve a su sitio
+    RENDER_SCALE,
+    RENDER_GEOMETRY, // Tramo de índices del lote vectorial
+    RENDER_POINTS,
+    RENDER_RECTS,
+    RENDER_TEXT
+} RenderCommandType;
+
+typedef struct {
+    RenderCommandType type;
+    SDL_Color color; // CLEAR, POINTS, RECTS y TEXT
+    int first;  // GEOMETRY: primer índice; POINTS y RECTS: primer elemento; TEXT: primer carácter
+    int count;  // GEOMETRY: índices; POINTS y RECTS: elementos
+    float x, y; // VIEWPORT: desplazamiento; SCALE: escala; TEXT: posición
+} RenderCommand;
+
+// Un fotograma grabado: las órdenes en el orden en que se dibujan y los datos a
+// los que apuntan. Los arrays crecen según haga falta y se reutilizan de un
+// fotograma a otro.
+typedef struct {
+    RenderCommand* commands;
+    int command_count;
+    int command_capacity;
+    VectorBatch vectors;  // Geometría de las órdenes GEOMETRY; los render_* añaden aquí con batch_*
+    int vectors_recorded; // Índices del lote que ya tienen su orden GEOMETRY
+    SDL_FPoint* points;
+    int point_count;
+    int point_capacity;
+    SDL_FRect* rects;
+    int rect_count;
+    int rect_capacity;
+    char* text; // Cadenas de las órdenes TEXT, cada una terminada en '\0'
+    int text_length;
+    int text_capacity;
+} RenderList;
+
+// Atlas de glifos: la fuente se rasteriza una sola vez en una textura
+typedef struct {
+    SDL_Texture* texture;
+    SDL_FRect src[TEXT_GLYPH_COUNT]; // Rectángulo de cada glifo dentro del atlas
+    float advance[TEXT_GLYPH_COUNT];
+    float width;
+    float height;
+} TextAtlas;
+
+// Cadena ya maquetada (quads listos para SDL_RenderGeometry)
+typedef struct {
+    bool valid;
+    Uint32 hash;
+    char text[TEXT_CACHE_MAX_LEN];
+    int x, y;
+    SDL_Color color;
+    int glyph_count;
+    Uint64 last_used;
+    SDL_Vertex vertices[TEXT_CACHE_MAX_LEN * 4];
+} CachedText;
+
+// Caché LRU de cadenas maquetadas: sólo se vuelve a maquetar si cambia el contenido
+typedef struct {
+    CachedText entries[TEXT_CACHE_SIZE];
+    int indices[TEXT_CACHE_MAX_LEN * 6]; // Índices compartidos por todas las entradas
+    Uint64 use_counter;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 evictions;
+} TextCache;
+
+// Valor del HUD con su texto ya formateado (sólo se reformatea al cambiar)
+typedef struct {
+    bool valid;
+    int value;
+    char text[32];
+} HudValue;
+
+// Entrada de la nave para un paso de simulación. La rellena handle_events a
+// partir del teclado o, en modo headless, el piloto automático. Las
+// pulsaciones (fire, hyperspace, new_game) quedan pendientes hasta el
+// siguiente paso, que las consume; así toda la entrada se aplica por pasos
+// y una grabación la puede repetir igual.
+typedef struct {
+    bool thrust;
+    bool turn_left;
+    bool turn_right;
+    bool fire;
+    bool hyperspace;
+    bool new_game; // Empezar partida (desde el menú)
+} InputState;
+
+// Grabación de la entrada en curso (--record); file es NULL si no se graba
+typedef struct {
+    SDL_IOStream* file;
+    Uint8 flags; // Entrada del tramo en curso
+    int run;     // Pasos seguidos con esa entrada
+    Uint64 ticks;
+    int games; // Partidas empezadas desde que se graba
+} Recording;
+
+// Una partida terminada, tal como se guarda en la tabla de récords
+typedef struct {
+    int score;
+    int level;
+    SDL_Time date; // Fin de la partida; 0 si no se conoce
+    char name[LEADERBOARD_NAME_SIZE];
+    char replay[LEADERBOARD_REPLAY_SIZE]; // Grabación que la contiene (--record) o ""
+    int replay_game;                      // Número de la partida dentro de esa grabación (desde 1)
+} ScoreEntry;
+
+// Mejores puntuaciones, de mayor a menor (ver scores.h)
+typedef struct {
+    ScoreEntry entries[LEADERBOARD_SIZE];
+    int count;
+    Uint64 sequence; // Versión de la tabla; cada inserción la incrementa
+    bool unsaved;    // Hay cambios que aún no se han mandado guardar
+    bool broken;     // El archivo no se pudo leer: no se escribe encima
+} Leaderboard;
+
+// Estado de un generador PCG32 (ver rng.h)
+typedef struct {
+    Uint64 state;
+    Uint64 inc; // Selecciona el flujo; siempre impar
+} Rng;
+
+// Opciones de ejecución (línea de comandos)
+typedef struct {
+    bool variable_step; // true: dt variable como antes; false: paso fijo
+    int tick_rate;      // Pasos de simulación por segundo en el modo de paso fijo
+    bool headless;      // Simular sin ventana ni renderizador
+    int headless_games;
+    int headless_max_ticks; // Límite de pasos por partida en modo headless
+    const char* kinematics; // Núcleo cinemático forzado ("avx2", "sse2", "scalar") o NULL
+    int threads; // --threads: hilos de la simulación, incluido el principal; 0 = uno por núcleo lógico
+    bool pipeline; // --pipeline: la simulación en su propio hilo, en paralelo con el dibujo
+    PoolCapacities capacities;
+    Uint64 seed; // Semilla de los generadores (--seed); por defecto, la hora de arranque
+    const char* record_path; // --record: grabar la entrada en este archivo
+    const char* replay_path; // --replay: simular esta grabación sin ventana
+    const char* player_name; // --name: nombre con el que se guardan los récords
+    const char* profile_path; // --profile: informe del perfilador al salir (make PROFILE=1)
+    const char* trace_path;   // --trace: traza de Chrome al salir; NULL = sólo con F4
+} Config;
 
 // Estructura principal del juego
 typedef struct {
     SDL_Window* window;
     SDL_Renderer* renderer;
     TTF_Font* font;
+    TextAtlas text_atlas;
+    RenderList frame; // Lo que se dibuja en el fotograma (render.h)
+    TextCache text_cache;
+    HudValue hud_score;
+    HudValue hud_highscore;
+    HudValue hud_lives;
     bool running;
     Uint64 last_time;
 
+    Config config;
+    float sim_dt;          // Duración de un paso fijo de simulación
+    float sim_accumulator; // Tiempo real pendiente de simular
+    float render_alpha;    // Fracción entre el paso anterior (0) y el actual (1)
+    SDL_FPoint camera;     // Esquina superior izquierda de la vista en el mundo, interpolada (update_camera)
+    Rng sim_rng;           // Todo lo que influye en la partida
+    Rng fx_rng;            // Sólo efectos visuales: estrellas, partículas, llama, temblor
+
+    InputState input;
+    Recording recording;
     Ship ship;
-    Bullet bullets[MAX_BULLETS];
-    Asteroid asteroids[MAX_ASTEROIDS];
+    BulletPool bullets;
+    AsteroidPool asteroids;
     UFO ufo;
-    Bullet ufo_bullets[MAX_BULLETS];
-    PowerUp powerups[MAX_POWERUPS];
-    Star stars[MAX_STARS];
-    Particle particles[MAX_PARTICLES];
+    BulletPool ufo_bullets;
+    PowerUpPool powerups;
+    StarPool stars;
+    ParticlePool particles;
+    SpatialGrid grid;
+    ContactBuffer contacts;
+    void* entity_arena; // Bloque del que salen los arrays de todas las pools
+    size_t entity_arena_size;
 
     int score;
-    int highscore;
+    int highscore; // La mejor entre la tabla y la partida en curso
+    Leaderboard leaderboard;
     int lives;
     int level;
 
@@ -130,11 +421,16 @@ typedef struct {
 } Game;
 
 // --- Prototipos de Funciones del Juego ---
-void save_highscore(int score);
 bool init_sdl(Game* game);
 void init_game_state(Game* game);
 void handle_events(Game* game);
+// Las partes de handle_events, para quien reparte los eventos (pipeline.c)
+void handle_window_event(Game* game, const SDL_Event* event);
+void handle_game_event(Game* game, const SDL_Event* event);
+void poll_held_keys(InputState* input);
 void cleanup(Game* game);
 void start_new_game(Game* game);
+void update_playing(Game* game, float dt);
+void update_game(Game* game, float dt);
 
 #endif // GAME_H
\ No newline at end of file
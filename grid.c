@@ -0,0 +1,75 @@
+#include "grid.h"
+#include "entities.h"
+#include <string.h>
+
+// Celda de una coordenada relativa a la vista; lo que cae fuera de la rejilla
+// se asigna a la celda del borde, así una consulta cerca del borde también lo
+// encuentra.
+static int cell_coord(float v, int cells) {
+    float c = (v + GRID_MARGIN) / GRID_CELL_SIZE;
+    if (c < 0.0f) return 0;
+    if (c >= (float)cells) return cells - 1;
+    return (int)c;
+}
+
+static int cell_index(const SpatialGrid* grid, float x, float y) {
+    return cell_coord(y - grid->origin.y, GRID_ROWS) * GRID_COLS + cell_coord(x - grid->origin.x, GRID_COLS);
+}
+
+// Encadena las 'count' entidades de la capa en la lista de su celda. Se
+// insertan de la última a la primera para que cada lista quede en orden de índice.
+static void build_layer(SpatialGrid* grid, GridLayer layer, int first, const float* pos_x, const float* pos_y, int count) {
+    int* head = grid->head[layer];
+    int* next = grid->next + first;
+
+    grid->first[layer] = first;
+    for (int i = count - 1; i >= 0; i--) {
+        int cell = cell_index(grid, pos_x[i], pos_y[i]);
+        next[i] = head[cell];
+        head[cell] = i;
+    }
+}
+
+void build_grid(Game* game) {
+    SpatialGrid* grid = &game->grid;
+    int first = 0;
+
+    // La rejilla cubre la vista, que sigue a la nave
+    grid->origin = view_origin(game);
+    memset(grid->head, 0xff, sizeof(grid->head)); // -1 en todas las celdas
+    build_layer(grid, GRID_ASTEROIDS, first, game->asteroids.pos_x, game->asteroids.pos_y, game->asteroids.count);
+    first += game->asteroids.count;
+    build_layer(grid, GRID_BULLETS, first, game->bullets.pos_x, game->bullets.pos_y, game->bullets.count);
+    first += game->bullets.count;
+    build_layer(grid, GRID_UFO_BULLETS, first, game->ufo_bullets.pos_x, game->ufo_bullets.pos_y, game->ufo_bullets.count);
+    first += game->ufo_bullets.count;
+    build_layer(grid, GRID_POWERUPS, first, game->powerups.pos_x, game->powerups.pos_y, game->powerups.count);
+}
+
+void begin_grid_query(GridQuery* query, const SpatialGrid* grid, GridLayer layer, float x, float y, float radius) {
+    query->head = grid->head[layer];
+    query->next = grid->next + grid->first[layer];
+    x -= grid->origin.x;
+    y -= grid->origin.y;
+    query->col0 = cell_coord(x - radius, GRID_COLS);
+    query->col1 = cell_coord(x + radius, GRID_COLS);
+    query->row1 = cell_coord(y + radius, GRID_ROWS);
+    query->row = cell_coord(y - radius, GRID_ROWS);
+    query->col = query->col0;
+    query->item = query->head[query->row * GRID_COLS + query->col];
+}
+
+int next_grid_query(GridQuery* query) {
+    while (query->item < 0) {
+        if (++query->col > query->col1) {
+            query->col = query->col0;
+            if (++query->row > query->row1) {
+                return -1;
+            }
+        }
+        query->item = query->head[query->row * GRID_COLS + query->col];
+    }
+    int i = query->item;
+    query->item = query->next[i];
+    return i;
+}
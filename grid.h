@@ -0,0 +1,27 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include "game.h"
+
+// --- Rejilla Uniforme de Colisiones ---
+// Se reconstruye una vez por paso con las posiciones de asteroides, balas y
+// power-ups. Los detectores de check_collisions sólo comprueban las entidades de
+// las celdas que solapan cada consulta en lugar de recorrer la pool entera.
+
+// Recorrido de las entidades de una capa que están en las celdas que solapan
+// un círculo. Es un filtro grueso: el llamador sigue comprobando la distancia.
+// Se recorre bajo demanda para poder cortar en cuanto hay un impacto.
+typedef struct {
+    const int* head;
+    const int* next;
+    int col0, col1, row1;
+    int row, col;
+    int item; // Próxima entidad de la celda actual, -1 al acabarla
+} GridQuery;
+
+void build_grid(Game* game);
+void begin_grid_query(GridQuery* query, const SpatialGrid* grid, GridLayer layer, float x, float y, float radius);
+// Devuelve el índice de la siguiente entidad, o -1 cuando no quedan
+int next_grid_query(GridQuery* query);
+
+#endif // GRID_H
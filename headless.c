@@ -0,0 +1,109 @@
+#include "headless.h"
+#include "entities.h"
+#include "profiler.h"
+#include <math.h>
+#include <stdlib.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// --- Piloto Automático ---
+
+// Apunta al asteroide más cercano, dispara cuando está alineado y salta al
+// hiperespacio si algo se acerca demasiado. Suficiente para que las partidas
+// avancen de nivel y terminen.
+static void autopilot(Game* game, int tick) {
+    SDL_FPoint center = game->ship.pos;
+    int target = -1;
+    float best_dist_sq = 0.0f;
+    for (int i = 0; i < game->asteroids.count; i++) {
+        float dx = game->asteroids.pos_x[i] - center.x;
+        float dy = game->asteroids.pos_y[i] - center.y;
+        float dist_sq = dx * dx + dy * dy;
+        if (target < 0 || dist_sq < best_dist_sq) {
+            target = i;
+            best_dist_sq = dist_sq;
+        }
+    }
+
+    game->input.thrust = false;
+    game->input.turn_left = false;
+    game->input.turn_right = false;
+    if (target < 0) {
+        return;
+    }
+
+    float dx = game->asteroids.pos_x[target] - center.x;
+    float dy = game->asteroids.pos_y[target] - center.y;
+    float wanted = atan2f(dy, dx) * (180.0f / M_PI);
+    float diff = fmodf(wanted - game->ship.angle + 540.0f, 360.0f) - 180.0f;
+
+    if (diff < -5.0f) {
+        game->input.turn_left = true;
+    } else if (diff > 5.0f) {
+        game->input.turn_right = true;
+    } else if (tick % 8 == 0) {
+        game->input.fire = true;
+    }
+
+    // Empuje ocasional para que la nave recorra el mundo y se mezclen las posiciones
+    game->input.thrust = (tick / 60) % 4 == 0;
+
+    float danger = game->asteroids.size[target] * 10.0f + SHIP_SIZE * 2.0f;
+    if (best_dist_sq < danger * danger) {
+        game->input.hyperspace = true;
+    }
+}
+
+// --- Bucle Headless ---
+
+bool run_headless(Game* game) {
+    const Config* config = &game->config;
+    if (config->headless_games <= 0 || config->headless_max_ticks <= 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "--games y --max-ticks deben ser mayores que 0");
+        return false;
+    }
+
+    init_game_state(game);
+
+    Uint64 total_ticks = 0;
+    Uint64 total_score = 0;
+    int best_score = 0;
+    int max_level = 0;
+    int finished_games = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    for (int g = 0; g < config->headless_games; g++) {
+        start_new_game(game);
+        start_level(game);
+
+        int tick = 0;
+        while (game->state == GAME_STATE_PLAYING && tick < config->headless_max_ticks) {
+            autopilot(game, tick);
+            update_playing(game, game->sim_dt);
+            profile_end_frame(); // Cada paso cuenta como un fotograma
+            tick++;
+        }
+
+        if (game->state == GAME_STATE_GAMEOVER) {
+            finished_games++;
+        }
+        total_ticks += (Uint64)tick;
+        total_score += (Uint64)game->score;
+        if (game->score > best_score) best_score = game->score;
+        if (game->level > max_level) max_level = game->level;
+    }
+
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    if (seconds <= 0.0) seconds = 1e-9;
+
+    SDL_Log("Headless: %d partidas (%d terminadas), %llu pasos de %.2f ms de juego",
+            config->headless_games, finished_games, (unsigned long long)total_ticks, game->sim_dt * 1000.0f);
+    SDL_Log("Headless: %.3f s reales, %.0f pasos/s, %.1f partidas/s, %.0fx tiempo real",
+            seconds, total_ticks / seconds, config->headless_games / seconds,
+            (total_ticks * game->sim_dt) / seconds);
+    SDL_Log("Headless: puntuación media %.1f, mejor %d, nivel máximo %d",
+            (double)total_score / config->headless_games, best_score, max_level);
+    return true;
+}
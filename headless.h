@@ -0,0 +1,11 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include "game.h"
+
+// --- Simulación sin ventana ni renderizador ---
+// Juega config.headless_games partidas con un piloto automático llamando
+// directamente a update_playing (que incluye check_collisions).
+bool run_headless(Game* game);
+
+#endif // HEADLESS_H
@@ -0,0 +1,198 @@
+#include "jobs.h"
+#include "defs.h"
+
+typedef struct {
+    JobFunc func;
+    void* data;
+    int begin;
+    int end;
+    JobGroup* group;
+} Job;
+
+// Cola de un hilo: las tareas están en [top, bottom), módulo JOB_QUEUE_SIZE.
+// Las colas son cortas y se tocan poco, así que basta un spinlock por cola.
+typedef struct {
+    SDL_SpinLock lock;
+    int top;    // Por aquí roban los demás hilos
+    int bottom; // Por aquí mete y saca el dueño
+    Job jobs[JOB_QUEUE_SIZE];
+} JobQueue;
+
+static struct {
+    JobQueue queues[JOB_MAX_THREADS]; // La 0, del que lanza las tareas (el de la simulación con --pipeline)
+    SDL_Thread* threads[JOB_MAX_THREADS];
+    int count; // Hilos con cola, incluido el principal
+    SDL_Semaphore* wake; // Una señal por tarea lanzada (o por trabajador, si son muchas)
+    SDL_AtomicInt quit;
+    SDL_TLSID slot; // Índice de la cola del hilo; sin valor (0) en el principal
+} jobs = { .count = 1 };
+
+static int current_queue(void) {
+    return (int)(intptr_t)SDL_GetTLS(&jobs.slot);
+}
+
+static bool push_job(int q, const Job* job) {
+    JobQueue* queue = &jobs.queues[q];
+    SDL_LockSpinlock(&queue->lock);
+    bool ok = queue->bottom - queue->top < JOB_QUEUE_SIZE;
+    if (ok) {
+        queue->jobs[queue->bottom % JOB_QUEUE_SIZE] = *job;
+        queue->bottom++;
+    }
+    SDL_UnlockSpinlock(&queue->lock);
+    return ok;
+}
+
+// 'own': el dueño saca la última que metió; si no, se roba la más antigua
+static bool take_job(int q, bool own, Job* job) {
+    JobQueue* queue = &jobs.queues[q];
+    SDL_LockSpinlock(&queue->lock);
+    bool ok = queue->top < queue->bottom;
+    if (ok) {
+        if (own) {
+            *job = queue->jobs[--queue->bottom % JOB_QUEUE_SIZE];
+        } else {
+            *job = queue->jobs[queue->top++ % JOB_QUEUE_SIZE];
+        }
+        if (queue->top == queue->bottom) {
+            queue->top = queue->bottom = 0; // Vacía: los índices vuelven a empezar
+        }
+    }
+    SDL_UnlockSpinlock(&queue->lock);
+    return ok;
+}
+
+// Primero la cola propia y después las de los demás, empezando por la siguiente
+static bool find_job(int self, Job* job) {
+    if (take_job(self, true, job)) {
+        return true;
+    }
+    for (int i = 1; i < jobs.count; i++) {
+        if (take_job((self + i) % jobs.count, false, job)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void execute_job(const Job* job) {
+    job->func(job->data, job->begin, job->end);
+    SDL_AddAtomicInt(&job->group->pending, -1);
+}
+
+static int SDLCALL worker_main(void* data) {
+    SDL_SetTLS(&jobs.slot, data, NULL);
+    int self = (int)(intptr_t)data;
+    Job job;
+    for (;;) {
+        SDL_WaitSemaphore(jobs.wake);
+        if (SDL_GetAtomicInt(&jobs.quit)) {
+            break;
+        }
+        while (find_job(self, &job)) {
+            execute_job(&job);
+        }
+    }
+    return 0;
+}
+
+bool init_jobs(int threads) {
+    if (threads < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "El número de hilos no puede ser negativo (es %d)", threads);
+        return false;
+    }
+    if (threads == 0) {
+        threads = SDL_GetNumLogicalCPUCores();
+    }
+    threads = SDL_clamp(threads, 1, JOB_MAX_THREADS);
+    if (threads == 1) {
+        return true;
+    }
+
+    jobs.wake = SDL_CreateSemaphore(0);
+    if (!jobs.wake) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Sin hilos para la simulación (%s)", SDL_GetError());
+        return true;
+    }
+    // Los trabajadores no miran jobs.count hasta que hay una tarea, y eso sólo
+    // pasa cuando esta función ha terminado
+    int count = 1;
+    for (; count < threads; count++) {
+        jobs.threads[count] = SDL_CreateThread(worker_main, "jobs", (void*)(intptr_t)count);
+        if (!jobs.threads[count]) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Sólo se pudieron crear %d de %d hilos (%s)",
+                        count, threads, SDL_GetError());
+            break;
+        }
+    }
+    jobs.count = count;
+    return true;
+}
+
+void shutdown_jobs(void) {
+    if (!jobs.wake) {
+        return;
+    }
+    SDL_SetAtomicInt(&jobs.quit, 1);
+    for (int i = 1; i < jobs.count; i++) {
+        SDL_SignalSemaphore(jobs.wake);
+    }
+    for (int i = 1; i < jobs.count; i++) {
+        SDL_WaitThread(jobs.threads[i], NULL);
+        jobs.threads[i] = NULL;
+    }
+    SDL_DestroySemaphore(jobs.wake);
+    jobs.wake = NULL;
+    jobs.count = 1;
+    SDL_SetAtomicInt(&jobs.quit, 0);
+}
+
+int job_thread_count(void) {
+    return jobs.count;
+}
+
+void run_job(JobGroup* group, JobFunc func, void* data, int begin, int end) {
+    Job job = { func, data, begin, end, group };
+    SDL_AddAtomicInt(&group->pending, 1);
+    if (jobs.count == 1 || !push_job(current_queue(), &job)) {
+        execute_job(&job); // Sin trabajadores o con la cola llena
+        return;
+    }
+    SDL_SignalSemaphore(jobs.wake);
+}
+
+void run_chunked(JobGroup* group, JobFunc func, void* data, int count, int chunk) {
+    if (count <= chunk || jobs.count == 1) {
+        if (count > 0) {
+            func(data, 0, count);
+        }
+        return;
+    }
+    int self = current_queue();
+    int pushed = 0;
+    for (int begin = 0; begin < count; begin += chunk) {
+        Job job = { func, data, begin, SDL_min(begin + chunk, count), group };
+        SDL_AddAtomicInt(&group->pending, 1);
+        if (push_job(self, &job)) {
+            pushed++;
+        } else {
+            execute_job(&job);
+        }
+    }
+    // Como mucho un trabajador por tramo; el que espera en wait_jobs también ayuda
+    for (int i = SDL_min(pushed, jobs.count - 1); i > 0; i--) {
+        SDL_SignalSemaphore(jobs.wake);
+    }
+}
+
+void wait_jobs(JobGroup* group) {
+    int self = current_queue();
+    Job job;
+    while (SDL_GetAtomicInt(&group->pending) > 0) {
+        if (find_job(self, &job)) {
+            execute_job(&job);
+        } else {
+            SDL_CPUPauseInstruction(); // Lo que queda lo están terminando otros hilos
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <SDL3/SDL.h>
+
+// --- Sistema de Tareas ---
+// Un grupo fijo de hilos trabajadores más el principal. Cada hilo tiene su
+// cola: mete y saca tareas por un extremo (la última que metió, que aún está
+// en caché) y los hilos sin trabajo roban por el otro (la más antigua). El
+// hilo que espera a un grupo no se duerme: ejecuta o roba tareas mientras
+// queden pendientes. Sin trabajadores (init_jobs(1) o si no se llamó a
+// init_jobs), todo se ejecuta al momento en el hilo que lo pide.
+
+// Procesa el tramo [begin, end) de lo que apunte 'data'
+typedef void (*JobFunc)(void* data, int begin, int end);
+
+// Tareas lanzadas que aún no han terminado; se inicializa a cero
+typedef struct {
+    SDL_AtomicInt pending;
+} JobGroup;
+
+// 'threads' cuenta el principal; 0 = uno por núcleo lógico. Si no se pueden
+// crear todos los hilos se sigue con los que haya.
+bool init_jobs(int threads);
+void shutdown_jobs(void);
+// Hilos que ejecutan tareas, incluido el principal
+int job_thread_count(void);
+
+void run_job(JobGroup* group, JobFunc func, void* data, int begin, int end);
+// Reparte [0, count) en tramos de 'chunk'; si sólo sale uno, se ejecuta ya
+void run_chunked(JobGroup* group, JobFunc func, void* data, int count, int chunk);
+// Vuelve cuando han terminado todas las tareas del grupo
+void wait_jobs(JobGroup* group);
+
+#endif // JOBS_H
@@ -0,0 +1,289 @@
+#include "kinematics.h"
+#include <SDL3/SDL_intrin.h>
+
+// --- Versión Escalar ---
+
+static void integrate_scalar(float* pos_x, float* pos_y, const float* vel_x, const float* vel_y,
+                             int count, float dt) {
+    for (int i = 0; i < count; i++) {
+        pos_x[i] = pos_x[i] + vel_x[i] * dt;
+        pos_y[i] = pos_y[i] + vel_y[i] * dt;
+    }
+}
+
+static void advance_scalar(float* value, const float* rate, int count, float dt) {
+    for (int i = 0; i < count; i++) {
+        value[i] = value[i] + rate[i] * dt;
+    }
+}
+
+static void damp_scalar(float* vel_x, float* vel_y, int count, float factor) {
+    for (int i = 0; i < count; i++) {
+        vel_x[i] = vel_x[i] * factor;
+        vel_y[i] = vel_y[i] * factor;
+    }
+}
+
+static void wrap_reset_scalar(float* pos, int count, float min, float max, float to_min, float to_max) {
+    for (int i = 0; i < count; i++) {
+        if (pos[i] < min) pos[i] = to_max;
+        if (pos[i] > max) pos[i] = to_min;
+    }
+}
+
+static int expire_scalar(float* lifetime, const float* pos_x, const float* pos_y, Uint8* expired,
+                         int count, float dt, const SDL_FRect* bounds) {
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        lifetime[i] -= dt;
+        bool dead = lifetime[i] <= 0;
+        if (bounds) {
+            dead = dead || pos_x[i] < bounds->x || pos_x[i] > bounds->x + bounds->w ||
+                   pos_y[i] < bounds->y || pos_y[i] > bounds->y + bounds->h;
+        }
+        expired[i] = dead;
+        total += dead;
+    }
+    return total;
+}
+
+static const KinematicsKernel scalar_kernel = {
+    "scalar",
+    integrate_scalar,
+    advance_scalar,
+    damp_scalar,
+    wrap_reset_scalar,
+    expire_scalar,
+};
+
+// Las versiones SIMD procesan bloques de 4 u 8 entidades y dejan el resto a
+// la escalar. Las comparaciones producen máscaras que se aplican con
+// and/andnot/or o blend, sin saltos dentro del bucle; la máscara de caducidad
+// se vuelca a un byte por entidad a partir de movemask.
+
+static inline int store_expired_bits(Uint8* out, int bits, int lanes) {
+    int total = 0;
+    for (int k = 0; k < lanes; k++) {
+        out[k] = (Uint8)((bits >> k) & 1);
+        total += out[k];
+    }
+    return total;
+}
+
+// --- Versión SSE2 ---
+
+#ifdef SDL_SSE2_INTRINSICS
+
+static inline __m128 SDL_TARGETING("sse2") select_sse2(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static void SDL_TARGETING("sse2") integrate_sse2(float* pos_x, float* pos_y, const float* vel_x, const float* vel_y,
+                                                 int count, float dt) {
+    __m128 vdt = _mm_set1_ps(dt);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(pos_x + i, _mm_add_ps(_mm_loadu_ps(pos_x + i), _mm_mul_ps(_mm_loadu_ps(vel_x + i), vdt)));
+        _mm_storeu_ps(pos_y + i, _mm_add_ps(_mm_loadu_ps(pos_y + i), _mm_mul_ps(_mm_loadu_ps(vel_y + i), vdt)));
+    }
+    integrate_scalar(pos_x + i, pos_y + i, vel_x + i, vel_y + i, count - i, dt);
+}
+
+static void SDL_TARGETING("sse2") advance_sse2(float* value, const float* rate, int count, float dt) {
+    __m128 vdt = _mm_set1_ps(dt);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(value + i, _mm_add_ps(_mm_loadu_ps(value + i), _mm_mul_ps(_mm_loadu_ps(rate + i), vdt)));
+    }
+    advance_scalar(value + i, rate + i, count - i, dt);
+}
+
+static void SDL_TARGETING("sse2") damp_sse2(float* vel_x, float* vel_y, int count, float factor) {
+    __m128 vfactor = _mm_set1_ps(factor);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(vel_x + i, _mm_mul_ps(_mm_loadu_ps(vel_x + i), vfactor));
+        _mm_storeu_ps(vel_y + i, _mm_mul_ps(_mm_loadu_ps(vel_y + i), vfactor));
+    }
+    damp_scalar(vel_x + i, vel_y + i, count - i, factor);
+}
+
+static void SDL_TARGETING("sse2") wrap_reset_sse2(float* pos, int count, float min, float max, float to_min, float to_max) {
+    __m128 vmin = _mm_set1_ps(min), vmax = _mm_set1_ps(max);
+    __m128 vto_min = _mm_set1_ps(to_min), vto_max = _mm_set1_ps(to_max);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 p = _mm_loadu_ps(pos + i);
+        p = select_sse2(_mm_cmplt_ps(p, vmin), vto_max, p);
+        p = select_sse2(_mm_cmpgt_ps(p, vmax), vto_min, p);
+        _mm_storeu_ps(pos + i, p);
+    }
+    wrap_reset_scalar(pos + i, count - i, min, max, to_min, to_max);
+}
+
+static int SDL_TARGETING("sse2") expire_sse2(float* lifetime, const float* pos_x, const float* pos_y, Uint8* expired,
+                                             int count, float dt, const SDL_FRect* bounds) {
+    __m128 vdt = _mm_set1_ps(dt), vzero = _mm_setzero_ps();
+    int total = 0;
+    int i = 0;
+    if (bounds) {
+        __m128 min_x = _mm_set1_ps(bounds->x), max_x = _mm_set1_ps(bounds->x + bounds->w);
+        __m128 min_y = _mm_set1_ps(bounds->y), max_y = _mm_set1_ps(bounds->y + bounds->h);
+        for (; i + 4 <= count; i += 4) {
+            __m128 l = _mm_sub_ps(_mm_loadu_ps(lifetime + i), vdt);
+            __m128 x = _mm_loadu_ps(pos_x + i);
+            __m128 y = _mm_loadu_ps(pos_y + i);
+            __m128 dead = _mm_or_ps(_mm_cmple_ps(l, vzero),
+                          _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(x, min_x), _mm_cmpgt_ps(x, max_x)),
+                                    _mm_or_ps(_mm_cmplt_ps(y, min_y), _mm_cmpgt_ps(y, max_y))));
+            _mm_storeu_ps(lifetime + i, l);
+            total += store_expired_bits(expired + i, _mm_movemask_ps(dead), 4);
+        }
+    } else {
+        for (; i + 4 <= count; i += 4) {
+            __m128 l = _mm_sub_ps(_mm_loadu_ps(lifetime + i), vdt);
+            _mm_storeu_ps(lifetime + i, l);
+            total += store_expired_bits(expired + i, _mm_movemask_ps(_mm_cmple_ps(l, vzero)), 4);
+        }
+    }
+    return total + expire_scalar(lifetime + i, pos_x + i, pos_y + i, expired + i, count - i, dt, bounds);
+}
+
+static const KinematicsKernel sse2_kernel = {
+    "sse2",
+    integrate_sse2,
+    advance_sse2,
+    damp_sse2,
+    wrap_reset_sse2,
+    expire_sse2,
+};
+
+#endif // SDL_SSE2_INTRINSICS
+
+// --- Versión AVX2 ---
+// Cada función termina con _mm256_zeroupper antes de volver a código SSE: con
+// SDL_TARGETING el compilador no lo inserta y, sin él, la transición entre
+// AVX y SSE penaliza al resto del paso de simulación.
+
+#ifdef SDL_AVX2_INTRINSICS
+
+static void SDL_TARGETING("avx2") integrate_avx2(float* pos_x, float* pos_y, const float* vel_x, const float* vel_y,
+                                                 int count, float dt) {
+    __m256 vdt = _mm256_set1_ps(dt);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(pos_x + i, _mm256_add_ps(_mm256_loadu_ps(pos_x + i), _mm256_mul_ps(_mm256_loadu_ps(vel_x + i), vdt)));
+        _mm256_storeu_ps(pos_y + i, _mm256_add_ps(_mm256_loadu_ps(pos_y + i), _mm256_mul_ps(_mm256_loadu_ps(vel_y + i), vdt)));
+    }
+    _mm256_zeroupper();
+    integrate_scalar(pos_x + i, pos_y + i, vel_x + i, vel_y + i, count - i, dt);
+}
+
+static void SDL_TARGETING("avx2") advance_avx2(float* value, const float* rate, int count, float dt) {
+    __m256 vdt = _mm256_set1_ps(dt);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(value + i, _mm256_add_ps(_mm256_loadu_ps(value + i), _mm256_mul_ps(_mm256_loadu_ps(rate + i), vdt)));
+    }
+    _mm256_zeroupper();
+    advance_scalar(value + i, rate + i, count - i, dt);
+}
+
+static void SDL_TARGETING("avx2") damp_avx2(float* vel_x, float* vel_y, int count, float factor) {
+    __m256 vfactor = _mm256_set1_ps(factor);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(vel_x + i, _mm256_mul_ps(_mm256_loadu_ps(vel_x + i), vfactor));
+        _mm256_storeu_ps(vel_y + i, _mm256_mul_ps(_mm256_loadu_ps(vel_y + i), vfactor));
+    }
+    _mm256_zeroupper();
+    damp_scalar(vel_x + i, vel_y + i, count - i, factor);
+}
+
+static void SDL_TARGETING("avx2") wrap_reset_avx2(float* pos, int count, float min, float max, float to_min, float to_max) {
+    __m256 vmin = _mm256_set1_ps(min), vmax = _mm256_set1_ps(max);
+    __m256 vto_min = _mm256_set1_ps(to_min), vto_max = _mm256_set1_ps(to_max);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 p = _mm256_loadu_ps(pos + i);
+        p = _mm256_blendv_ps(p, vto_max, _mm256_cmp_ps(p, vmin, _CMP_LT_OQ));
+        p = _mm256_blendv_ps(p, vto_min, _mm256_cmp_ps(p, vmax, _CMP_GT_OQ));
+        _mm256_storeu_ps(pos + i, p);
+    }
+    _mm256_zeroupper();
+    wrap_reset_scalar(pos + i, count - i, min, max, to_min, to_max);
+}
+
+static int SDL_TARGETING("avx2") expire_avx2(float* lifetime, const float* pos_x, const float* pos_y, Uint8* expired,
+                                             int count, float dt, const SDL_FRect* bounds) {
+    __m256 vdt = _mm256_set1_ps(dt), vzero = _mm256_setzero_ps();
+    int total = 0;
+    int i = 0;
+    if (bounds) {
+        __m256 min_x = _mm256_set1_ps(bounds->x), max_x = _mm256_set1_ps(bounds->x + bounds->w);
+        __m256 min_y = _mm256_set1_ps(bounds->y), max_y = _mm256_set1_ps(bounds->y + bounds->h);
+        for (; i + 8 <= count; i += 8) {
+            __m256 l = _mm256_sub_ps(_mm256_loadu_ps(lifetime + i), vdt);
+            __m256 x = _mm256_loadu_ps(pos_x + i);
+            __m256 y = _mm256_loadu_ps(pos_y + i);
+            __m256 dead = _mm256_or_ps(_mm256_cmp_ps(l, vzero, _CMP_LE_OQ),
+                          _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(x, min_x, _CMP_LT_OQ), _mm256_cmp_ps(x, max_x, _CMP_GT_OQ)),
+                                       _mm256_or_ps(_mm256_cmp_ps(y, min_y, _CMP_LT_OQ), _mm256_cmp_ps(y, max_y, _CMP_GT_OQ))));
+            _mm256_storeu_ps(lifetime + i, l);
+            total += store_expired_bits(expired + i, _mm256_movemask_ps(dead), 8);
+        }
+    } else {
+        for (; i + 8 <= count; i += 8) {
+            __m256 l = _mm256_sub_ps(_mm256_loadu_ps(lifetime + i), vdt);
+            _mm256_storeu_ps(lifetime + i, l);
+            total += store_expired_bits(expired + i, _mm256_movemask_ps(_mm256_cmp_ps(l, vzero, _CMP_LE_OQ)), 8);
+        }
+    }
+    _mm256_zeroupper();
+    return total + expire_scalar(lifetime + i, pos_x + i, pos_y + i, expired + i, count - i, dt, bounds);
+}
+
+static const KinematicsKernel avx2_kernel = {
+    "avx2",
+    integrate_avx2,
+    advance_avx2,
+    damp_avx2,
+    wrap_reset_avx2,
+    expire_avx2,
+};
+
+#endif // SDL_AVX2_INTRINSICS
+
+// --- Selección ---
+
+const KinematicsKernel* kinematics = &scalar_kernel;
+
+bool init_kinematics(const char* preferred) {
+    const KinematicsKernel* best = &scalar_kernel;
+#ifdef SDL_SSE2_INTRINSICS
+    bool has_sse2 = SDL_HasSSE2();
+    if (has_sse2) best = &sse2_kernel;
+#endif
+#ifdef SDL_AVX2_INTRINSICS
+    bool has_avx2 = SDL_HasAVX2();
+    if (has_avx2) best = &avx2_kernel;
+#endif
+
+    if (!preferred) {
+        kinematics = best;
+    } else if (SDL_strcmp(preferred, "scalar") == 0) {
+        kinematics = &scalar_kernel;
+#ifdef SDL_SSE2_INTRINSICS
+    } else if (SDL_strcmp(preferred, "sse2") == 0 && has_sse2) {
+        kinematics = &sse2_kernel;
+#endif
+#ifdef SDL_AVX2_INTRINSICS
+    } else if (SDL_strcmp(preferred, "avx2") == 0 && has_avx2) {
+        kinematics = &avx2_kernel;
+#endif
+    } else {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Núcleo cinemático no disponible: %s", preferred);
+        return false;
+    }
+    return true;
+}
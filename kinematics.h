@@ -0,0 +1,35 @@
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+#include <SDL3/SDL.h>
+
+// --- Núcleo de Integración Cinemática ---
+// Operaciones sobre los arrays de una pool SoA. Cada función tiene versión
+// AVX2, SSE2 y escalar; init_kinematics elige la mejor que soporte la CPU.
+// Todas hacen las operaciones en el mismo orden que la escalar, así que el
+// resultado es idéntico bit a bit sea cual sea la versión elegida.
+
+typedef struct {
+    const char* name;
+    // pos = pos + vel * dt, en los dos ejes
+    void (*integrate)(float* pos_x, float* pos_y, const float* vel_x, const float* vel_y, int count, float dt);
+    // value = value + rate * dt (ángulos)
+    void (*advance)(float* value, const float* rate, int count, float dt);
+    // vel = vel * factor, en los dos ejes (fricción)
+    void (*damp)(float* vel_x, float* vel_y, int count, float factor);
+    // pos < min -> to_max; pos > max -> to_min (wrap de los asteroides)
+    void (*wrap_reset)(float* pos, int count, float min, float max, float to_min, float to_max);
+    // lifetime -= dt; expired[i] = lifetime <= 0 o, si bounds no es NULL, la
+    // posición está fuera de bounds. Devuelve cuántas entidades han caducado.
+    int (*expire)(float* lifetime, const float* pos_x, const float* pos_y, Uint8* expired,
+                  int count, float dt, const SDL_FRect* bounds);
+} KinematicsKernel;
+
+// Versión en uso; hasta llamar a init_kinematics es la escalar
+extern const KinematicsKernel* kinematics;
+
+// Elige la versión: NULL para la mejor disponible, o "avx2", "sse2", "scalar".
+// Devuelve false si la pedida no existe o la CPU no la soporta.
+bool init_kinematics(const char* preferred);
+
+#endif // KINEMATICS_H
@@ -1,6 +1,14 @@
 #include "game.h"
 #include "entities.h"
 #include "utils.h"
+#include "headless.h"
+#include "kinematics.h"
+#include "render.h"
+#include "replay.h"
+#include "rng.h"
+#include "profiler.h"
+#include "jobs.h"
+#include "pipeline.h"
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
@@ -8,185 +16,285 @@
 // --- Prototipos de Funciones (definidas en main.c) ---
 // (Funciones definidas en game.c y entities.c son declaradas en sus respectivos .h)
 
-void update_game(Game* game, float dt);
 void render_game(Game* game);
+static bool parse_args(Config* config, int argc, char* argv[]);
+static void run_serial_loop(Game* game);
 
 // --- Función Principal ---
 int main(int argc, char* argv[]) {
     Game game = {0};
-    srand((unsigned int)time(NULL));
 
-    if (!init_sdl(&game)) {
+    if (!parse_args(&game.config, argc, argv)) {
         return 1;
     }
-
-    init_game_state(&game);
-
-    game.running = true;
-    game.last_time = SDL_GetPerformanceCounter();
-
-    while (game.running) {
-        Uint64 current_time = SDL_GetPerformanceCounter();
-        float dt = (current_time - game.last_time) / (float)SDL_GetPerformanceFrequency();
-        game.last_time = current_time;
-
-        // Limitar el delta time para evitar saltos en la física si el juego se congela
-        if (dt > 0.05f) {
-            dt = 0.05f;
-        }
-
-        handle_events(&game);
-        update_game(&game, dt);
-        render_game(&game);
-    }
-
-    cleanup(&game);
-    return 0;
-}
-
-void update_playing(Game* game, float dt) {
-    // Aumentar la dificultad con el tiempo, con un límite
-    if (game->score > game->highscore) {
-        game->highscore = game->score;
+    game.sim_dt = 1.0f / (float)game.config.tick_rate;
+    if (!init_kinematics(game.config.kinematics)) {
+        return 1;
     }
-
-    // Aumentar la dificultad con el tiempo, con un límite
-    game->difficulty_factor += 0.002f * dt; // Aumenta un 0.12 por minuto
-    if (game->difficulty_factor > 3.0f) {
-        game->difficulty_factor = 3.0f; // Límite para no hacerlo imposible
+    SDL_Log("Núcleo cinemático: %s", kinematics->name);
+    if (!init_jobs(game.config.threads)) {
+        return 1;
     }
-
-    // --- Actualizar Nave ---
-    if (game->respawn_timer > 0) {
-        game->respawn_timer -= dt;
+    SDL_Log("Hilos de la simulación: %d", job_thread_count());
+
+    if (game.config.replay_path) {
+        // Semilla, tick rate y pools salen de la grabación
+        bool ok = run_replay(&game);
+        free_entity_pools(&game);
+        shutdown_jobs();
+        return ok ? 0 : 1;
     }
-    update_ship(game, dt);
-
-    update_hyperspace(game, dt);
 
-    // Actualizar timers de power-ups
-    if (game->shield_timer > 0) {
-        game->shield_timer -= dt;
-    }
-    if (game->triple_shot_timer > 0) {
-        game->triple_shot_timer -= dt;
+    seed_game_rngs(&game, game.config.seed);
+    SDL_Log("Semilla: %llu", (unsigned long long)game.config.seed);
+    if (!init_entity_pools(&game, &game.config.capacities)) {
+        return 1;
     }
 
-    // Actualizar screen shake
-    if (game->shake_timer > 0) {
-        game->shake_timer -= dt;
-        if (game->shake_timer <= 0) {
-            game->shake_timer = 0.0f;
-            game->shake_intensity = 0.0f;
+    if (game.config.headless) {
+        bool ok = run_headless(&game);
+        write_profile_report(game.config.profile_path);
+        if (game.config.trace_path) {
+            write_trace(game.config.trace_path);
         }
+        log_pool_usage(&game);
+        free_entity_pools(&game);
+        shutdown_jobs();
+        return ok ? 0 : 1;
     }
 
-    update_stars(game, dt);
-    update_ufo(game, dt);
-    update_bullets(game, dt);
-    update_ufo_bullets(game, dt);
-    update_asteroids(game, dt);
-    update_powerups(game, dt);
-    update_particles(game, dt);
+    if (!init_sdl(&game)) {
+        return 1;
+    }
 
-    check_collisions(game);
+    init_game_state(&game);
+    if (game.config.record_path && !start_recording(&game, game.config.record_path)) {
+        cleanup(&game);
+        return 1;
+    }
 
-    bool level_cleared = true;
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        if (game->asteroids[i].active) {
-            level_cleared = false;
-            break;
-        }
+    game.running = true;
+    // Si no se puede arrancar el hilo de la simulación se sigue con el bucle de siempre
+    if (!game.config.pipeline || !run_pipelined(&game)) {
+        run_serial_loop(&game);
     }
 
-    if (level_cleared && game->state == GAME_STATE_PLAYING) {
-        start_level(game);
-        reset_ship(game, false);
+    write_profile_report(game.config.profile_path);
+    if (game.config.trace_path) {
+        write_trace(game.config.trace_path);
     }
+    cleanup(&game);
+    return 0;
 }
 
-void update_game(Game* game, float dt) {
-    // Las estrellas se mueven en el menú para dar un efecto dinámico
-    if (game->state == GAME_STATE_MENU) {
-        update_stars(game, dt);
-    }
+// --- Bucle Principal ---
+// Eventos, simulación y dibujo, uno detrás de otro en el mismo hilo
+static void run_serial_loop(Game* game) {
+    game->last_time = SDL_GetPerformanceCounter();
+
+    while (game->running) {
+        Uint64 current_time = SDL_GetPerformanceCounter();
+        float dt = (current_time - game->last_time) / (float)SDL_GetPerformanceFrequency();
+        game->last_time = current_time;
+
+        PROFILE_BEGIN(PROFILE_EVENTS);
+        handle_events(game);
+        PROFILE_END(PROFILE_EVENTS);
+
+        PROFILE_BEGIN(PROFILE_UPDATE);
+
+        if (game->config.variable_step) {
+            // Limitar el delta time para evitar saltos en la física si el juego se congela
+            if (dt > MAX_VARIABLE_DT) {
+                dt = MAX_VARIABLE_DT;
+            }
+            update_game(game, dt);
+            game->render_alpha = 1.0f;
+        } else {
+            // Paso fijo: se simulan tantos pasos de sim_dt como tiempo real haya pasado
+            // y el resto se usa para interpolar entre los dos últimos estados al dibujar
+            if (dt > MAX_FRAME_TIME) {
+                dt = MAX_FRAME_TIME;
+            }
+            game->sim_accumulator += dt;
+            while (game->sim_accumulator >= game->sim_dt) {
+                update_game(game, game->sim_dt);
+                game->sim_accumulator -= game->sim_dt;
+            }
+            game->render_alpha = game->sim_accumulator / game->sim_dt;
+        }
+        PROFILE_END(PROFILE_UPDATE);
 
-    if (game->state == GAME_STATE_PLAYING) {
-        update_playing(game, dt);
+        render_game(game);
+        profile_end_frame();
     }
+}
 
-    if (game->state == GAME_STATE_GAMEOVER) {
-        if (game->score > game->highscore) {
-            save_highscore(game->score);
+static bool parse_args(Config* config, int argc, char* argv[]) {
+    config->variable_step = false;
+    config->tick_rate = SIM_TICK_RATE;
+    config->headless = false;
+    config->headless_games = HEADLESS_DEFAULT_GAMES;
+    config->headless_max_ticks = HEADLESS_DEFAULT_MAX_TICKS;
+    config->kinematics = NULL;
+    config->threads = 0;
+    config->pipeline = false;
+    config->capacities = (PoolCapacities){
+        DEFAULT_MAX_BULLETS, DEFAULT_MAX_ASTEROIDS, DEFAULT_MAX_POWERUPS, DEFAULT_MAX_STARS, DEFAULT_MAX_PARTICLES
+    };
+    config->seed = (Uint64)time(NULL);
+    config->record_path = NULL;
+    config->replay_path = NULL;
+    config->player_name = DEFAULT_PLAYER_NAME;
+    config->profile_path = PROFILE_REPORT_FILE;
+    config->trace_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--variable-step") == 0) {
+            config->variable_step = true;
+        } else if (SDL_strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            config->tick_rate = SDL_atoi(argv[++i]);
+            if (config->tick_rate <= 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "--tick-rate debe ser mayor que 0");
+                return false;
+            }
+        } else if (SDL_strcmp(argv[i], "--headless") == 0) {
+            config->headless = true;
+        } else if (SDL_strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            config->headless_games = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--max-ticks") == 0 && i + 1 < argc) {
+            config->headless_max_ticks = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+            config->kinematics = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config->threads = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--pipeline") == 0) {
+            config->pipeline = true;
+        } else if (SDL_strcmp(argv[i], "--max-bullets") == 0 && i + 1 < argc) {
+            config->capacities.bullets = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--max-asteroids") == 0 && i + 1 < argc) {
+            config->capacities.asteroids = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--max-powerups") == 0 && i + 1 < argc) {
+            config->capacities.powerups = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--max-stars") == 0 && i + 1 < argc) {
+            config->capacities.stars = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--max-particles") == 0 && i + 1 < argc) {
+            config->capacities.particles = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config->seed = SDL_strtoull(argv[++i], NULL, 10);
+        } else if (SDL_strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            config->record_path = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            config->replay_path = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            config->player_name = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            config->profile_path = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            config->trace_path = argv[++i];
+        } else {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Opción desconocida: %s", argv[i]);
+            SDL_Log("Uso: %s [--variable-step] [--tick-rate HZ] [--headless [--games N] [--max-ticks N]] [--kernel avx2|sse2|scalar] [--threads N] [--pipeline] "
+                    "[--max-bullets N] [--max-asteroids N] [--max-powerups N] [--max-stars N] [--max-particles N] [--seed N] [--record ARCHIVO | --replay ARCHIVO] [--name NOMBRE] [--profile ARCHIVO] [--trace ARCHIVO]", argv[0]);
+            return false;
         }
     }
+    // La grabación necesita pasos de duración fija y la entrada del teclado
+    if (config->record_path && (config->variable_step || config->headless || config->replay_path)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "--record no se puede usar con --variable-step, --headless ni --replay");
+        return false;
+    }
+    return true;
 }
 
 void render_menu(Game* game) {
     SDL_Color white = {255, 255, 255, 255};
     SDL_Color yellow = {255, 255, 0, 255};
 
-    draw_text(game, "ASTEROIDS", SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 - 100, white);
+    record_text(&game->frame, "ASTEROIDS", SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 - 100, white);
 
     SDL_Color play_color = (game->menu_selection == 0) ? yellow : white;
-    draw_text(game, "Jugar", SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2, play_color);
+    record_text(&game->frame, "Jugar", SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2, play_color);
 
     SDL_Color exit_color = (game->menu_selection == 1) ? yellow : white;
-    draw_text(game, "Salir", SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 + 40, exit_color);
+    record_text(&game->frame, "Salir", SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 + 40, exit_color);
+
+    // Mejores puntuaciones: "1. NOMBRE     12345" (20 caracteres de 20px)
+    const Leaderboard* board = &game->leaderboard;
+    for (int i = 0; i < board->count && i < LEADERBOARD_MENU_ROWS; i++) {
+        char line[32];
+        SDL_snprintf(line, sizeof(line), "%d. %-10.10s %6d", i + 1, board->entries[i].name, board->entries[i].score);
+        record_text(&game->frame, line, SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2 + 100 + i * 25, white);
+    }
 }
 
 void render_playing(Game* game) {
-    SDL_SetRenderDrawColor(game->renderer, 0, 0, 0, 255);
-    SDL_RenderClear(game->renderer);
-
     // Renderizar las estrellas primero para que queden en el fondo
+    PROFILE_BEGIN(PROFILE_RENDER_STARS);
     render_stars(game);
+    PROFILE_END(PROFILE_RENDER_STARS);
 
+    PROFILE_BEGIN(PROFILE_RENDER_SHIP);
     render_ship(game);
+    PROFILE_END(PROFILE_RENDER_SHIP);
+    PROFILE_BEGIN(PROFILE_RENDER_BULLETS);
     render_bullets(game);
+    PROFILE_END(PROFILE_RENDER_BULLETS);
+    PROFILE_BEGIN(PROFILE_RENDER_UFO);
     render_ufo(game);
+    PROFILE_END(PROFILE_RENDER_UFO);
+    PROFILE_BEGIN(PROFILE_RENDER_UFO_BULLETS);
     render_ufo_bullets(game);
+    PROFILE_END(PROFILE_RENDER_UFO_BULLETS);
+    PROFILE_BEGIN(PROFILE_RENDER_POWERUPS);
     render_powerups(game);
+    PROFILE_END(PROFILE_RENDER_POWERUPS);
+    PROFILE_BEGIN(PROFILE_RENDER_ASTEROIDS);
     render_asteroids(game);
+    PROFILE_END(PROFILE_RENDER_ASTEROIDS);
+    PROFILE_BEGIN(PROFILE_RENDER_PARTICLES);
     render_particles(game);
+    PROFILE_END(PROFILE_RENDER_PARTICLES);
 
     // --- Dibujar UI ---
+    // Todas las entidades vectoriales y las partículas quedan en una sola orden
+    // de geometría, antes del texto
     SDL_Color white = {255, 255, 255, 255};
-    char text_buffer[100];
-    snprintf(text_buffer, sizeof(text_buffer), "SCORE: %d", game->score);
-    draw_text(game, text_buffer, 10, 10, white);
-
-    snprintf(text_buffer, sizeof(text_buffer), "HIGH: %d", game->highscore);
-    draw_text(game, text_buffer, SCREEN_WIDTH / 2 - 70, 10, white);
-
-    snprintf(text_buffer, sizeof(text_buffer), "LIVES: %d", game->lives); // "LIVES: X" son 8 caracteres
-    draw_text(game, text_buffer, SCREEN_WIDTH - (8 * 20) - 10, 10, white); // 8 chars * 20px/char (aprox) + 10px padding
+    record_text(&game->frame, format_hud_value(&game->hud_score, "SCORE", game->score), 10, 10, white);
+    record_text(&game->frame, format_hud_value(&game->hud_highscore, "HIGH", game->highscore), SCREEN_WIDTH / 2 - 70, 10, white);
+    // "LIVES: X" son 8 caracteres
+    record_text(&game->frame, format_hud_value(&game->hud_lives, "LIVES", game->lives), SCREEN_WIDTH - (8 * 20) - 10, 10, white); // 8 chars * 20px/char (aprox) + 10px padding
 
     if (game->state == GAME_STATE_PAUSED) {
-        draw_text(game, "PAUSA", SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 - 20, white);
+        record_text(&game->frame, "PAUSA", SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 - 20, white);
     }
 }
 
 void render_gameover(Game* game) {
     SDL_Color white = {255, 255, 255, 255};
-    draw_text(game, "GAME OVER", SCREEN_WIDTH / 2 - 110, SCREEN_HEIGHT / 2 - 50, white);
-    draw_text(game, "Press SPACE to return to menu", SCREEN_WIDTH / 2 - 280, SCREEN_HEIGHT / 2, white);
+    record_text(&game->frame, "GAME OVER", SCREEN_WIDTH / 2 - 110, SCREEN_HEIGHT / 2 - 50, white);
+    record_text(&game->frame, "Press SPACE to return to menu", SCREEN_WIDTH / 2 - 280, SCREEN_HEIGHT / 2, white);
 }
 
+// Graba el fotograma en game->frame y después lo dibuja (ver render.h)
 void render_game(Game* game) {
-    SDL_SetRenderDrawColor(game->renderer, 0, 0, 0, 255);
-    SDL_RenderClear(game->renderer);
+    PROFILE_BEGIN(PROFILE_RENDER);
+    update_camera(game);
+    RenderList* frame = &game->frame;
+    begin_render_list(frame);
+    record_clear(frame, (SDL_Color){0, 0, 0, 255});
     
     // Aplicar Screen Shake
     if (game->shake_timer > 0) {
-        float offset_x = ((float)rand() / RAND_MAX * 2.0f - 1.0f) * game->shake_intensity;
-        float offset_y = ((float)rand() / RAND_MAX * 2.0f - 1.0f) * game->shake_intensity;
-        SDL_Rect viewport = { (int)offset_x, (int)offset_y, SCREEN_WIDTH, SCREEN_HEIGHT };
-        SDL_SetRenderViewport(game->renderer, &viewport);
+        float offset_x = (rng_float(&game->fx_rng) * 2.0f - 1.0f) * game->shake_intensity;
+        float offset_y = (rng_float(&game->fx_rng) * 2.0f - 1.0f) * game->shake_intensity;
+        record_viewport(frame, (float)(int)offset_x, (float)(int)offset_y);
     }
 
     if (game->state == GAME_STATE_MENU) {
+        PROFILE_BEGIN(PROFILE_RENDER_STARS);
         render_stars(game);
+        PROFILE_END(PROFILE_RENDER_STARS);
         render_menu(game);
     } else if (game->state == GAME_STATE_PLAYING || game->state == GAME_STATE_PAUSED) {
         render_playing(game);
@@ -197,8 +305,17 @@ void render_game(Game* game) {
 
     // Restaurar el offset del renderizador para que la UI no se vea afectada (si la hubiera)
     if (game->shake_timer > 0) {
-        SDL_SetRenderViewport(game->renderer, NULL);
+        record_viewport(frame, 0.0f, 0.0f);
     }
+    render_profile_overlay(game);
+    end_render_list(frame);
+
+    PROFILE_BEGIN(PROFILE_RENDER_SUBMIT);
+    submit_render_list(game);
+    PROFILE_END(PROFILE_RENDER_SUBMIT);
+    PROFILE_END(PROFILE_RENDER);
 
+    PROFILE_BEGIN(PROFILE_PRESENT);
     SDL_RenderPresent(game->renderer);
+    PROFILE_END(PROFILE_PRESENT);
 }
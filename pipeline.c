@@ -0,0 +1,275 @@
+#include "pipeline.h"
+#include "entities.h"
+#include "profiler.h"
+
+void render_game(Game* game); // main.c
+
+#define SNAPSHOT_COUNT 3
+#define SNAPSHOT_FRESH 4 // Bit de 'middle': la del medio es nueva y el principal aún no la ha recogido
+
+typedef struct {
+    Game state;  // Sólo se usa lo que dibujan los render_*; las pools tienen su propio bloque
+    Uint64 time; // Momento (SDL_GetPerformanceCounter) al que corresponde el último paso
+} Snapshot;
+
+static struct {
+    Snapshot* slots[SNAPSHOT_COUNT];
+    SDL_AtomicInt middle; // Índice de la instantánea del medio | SNAPSHOT_FRESH
+    int back;  // La que rellena la simulación
+    int front; // La que dibuja el principal
+    Game* sim; // Estado de la partida; sólo lo toca el hilo de la simulación
+    SDL_Thread* thread;
+    SDL_AtomicInt quit;     // El principal pide parar
+    SDL_AtomicInt finished; // La simulación ha parado por su cuenta (Salir en el menú)
+
+    // Buzón de entrada: teclas pulsadas desde el último paso y las que se mantienen
+    SDL_Mutex* input_lock;
+    SDL_Event events[PIPELINE_INPUT_EVENTS];
+    int event_count;
+    InputState held;
+} pipeline;
+
+// --- Instantáneas ---
+
+// Lo que se dibuja y no está en las pools
+static void copy_frame_state(Game* dst, const Game* src) {
+    dst->ship = src->ship;
+    dst->ufo = src->ufo;
+    dst->score = src->score;
+    dst->highscore = src->highscore;
+    dst->leaderboard = src->leaderboard;
+    dst->lives = src->lives;
+    dst->level = src->level;
+    dst->state = src->state;
+    dst->menu_selection = src->menu_selection;
+    dst->respawn_timer = src->respawn_timer;
+    dst->hyperspace_active = src->hyperspace_active;
+    dst->shield_timer = src->shield_timer;
+    dst->triple_shot_timer = src->triple_shot_timer;
+    dst->shake_timer = src->shake_timer;
+    dst->shake_intensity = src->shake_intensity;
+}
+
+// Hilo de la simulación
+static void publish_snapshot(const Game* sim, Uint64 time) {
+    Snapshot* snapshot = pipeline.slots[pipeline.back];
+    copy_frame_state(&snapshot->state, sim);
+    snapshot_entity_pools(&snapshot->state, sim);
+    snapshot->time = time;
+    // La rellenada pasa al medio y la que estaba en el medio queda para la próxima
+    pipeline.back = SDL_SetAtomicInt(&pipeline.middle, pipeline.back | SNAPSHOT_FRESH) & ~SNAPSHOT_FRESH;
+}
+
+// Hilo principal. Si hay una más reciente, la del medio pasa a dibujarse y la
+// que se dibujaba queda libre para la simulación.
+static bool acquire_snapshot(void) {
+    if (!(SDL_GetAtomicInt(&pipeline.middle) & SNAPSHOT_FRESH)) {
+        return false;
+    }
+    pipeline.front = SDL_SetAtomicInt(&pipeline.middle, pipeline.front) & ~SNAPSHOT_FRESH;
+    return true;
+}
+
+// Las pools del principal pasan a apuntar a las de la instantánea: no se
+// copia nada, y los render_* sólo las leen.
+static void show_snapshot(Game* game, const Snapshot* snapshot) {
+    const Game* state = &snapshot->state;
+    copy_frame_state(game, state);
+    game->bullets = state->bullets;
+    game->ufo_bullets = state->ufo_bullets;
+    game->asteroids = state->asteroids;
+    game->powerups = state->powerups;
+    game->stars = state->stars;
+    game->particles = state->particles;
+}
+
+// --- Entrada ---
+
+// Hilo principal: lo global se atiende aquí y las teclas van al buzón. Los
+// eventos se recogen sin el cerrojo (atenderlos puede escribir en disco y
+// SDL_PollEvent puede no volver mientras se arrastra la ventana), así que la
+// simulación sólo espera a que se copien.
+static void forward_events(Game* game) {
+    SDL_Event event;
+    SDL_Event keys[PIPELINE_INPUT_EVENTS];
+    int count = 0;
+    while (SDL_PollEvent(&event)) {
+        handle_window_event(game, &event);
+        if (event.type == SDL_EVENT_KEY_DOWN && count < PIPELINE_INPUT_EVENTS) {
+            keys[count++] = event;
+        }
+    }
+    InputState held = {0};
+    poll_held_keys(&held);
+
+    SDL_LockMutex(pipeline.input_lock);
+    int room = PIPELINE_INPUT_EVENTS - pipeline.event_count;
+    count = SDL_min(count, room);
+    SDL_memcpy(&pipeline.events[pipeline.event_count], keys, sizeof(SDL_Event) * count);
+    pipeline.event_count += count;
+    pipeline.held = held;
+    SDL_UnlockMutex(pipeline.input_lock);
+}
+
+// Hilo de la simulación: como handle_events, pero con lo que dejó el principal
+static void apply_input(Game* sim) {
+    SDL_Event events[PIPELINE_INPUT_EVENTS];
+    SDL_LockMutex(pipeline.input_lock);
+    int count = pipeline.event_count;
+    SDL_memcpy(events, pipeline.events, sizeof(SDL_Event) * count);
+    pipeline.event_count = 0;
+    sim->input.thrust = pipeline.held.thrust;
+    sim->input.turn_left = pipeline.held.turn_left;
+    sim->input.turn_right = pipeline.held.turn_right;
+    SDL_UnlockMutex(pipeline.input_lock);
+
+    for (int i = 0; i < count; i++) {
+        handle_game_event(sim, &events[i]);
+    }
+}
+
+// --- Hilo de la Simulación ---
+
+// Paso fijo con su propio reloj; duerme hasta que toca el siguiente paso.
+// Es el que lanza las tareas de update_entities (ver jobs.h).
+static int SDLCALL simulation_main(void* data) {
+    Game* sim = data;
+    Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 tick = freq / (Uint64)sim->config.tick_rate;
+    Uint64 max_lag = (Uint64)(MAX_FRAME_TIME * freq);
+    Uint64 sim_time = SDL_GetPerformanceCounter(); // Momento al que corresponde el estado
+
+    while (!SDL_GetAtomicInt(&pipeline.quit) && sim->running) {
+        apply_input(sim);
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now - sim_time > max_lag) {
+            sim_time = now - max_lag; // Tras un tirón no se recupera todo
+        }
+        if (sim->running && sim_time + tick <= now) {
+            PROFILE_BEGIN(PROFILE_UPDATE);
+            do {
+                update_game(sim, sim->sim_dt);
+                sim_time += tick;
+            } while (sim_time + tick <= now);
+            PROFILE_END(PROFILE_UPDATE);
+            publish_snapshot(sim, sim_time);
+        }
+
+        now = SDL_GetPerformanceCounter();
+        if (sim_time + tick > now) {
+            SDL_DelayNS((sim_time + tick - now) * SDL_NS_PER_SECOND / freq);
+        }
+    }
+    SDL_SetAtomicInt(&pipeline.finished, 1);
+    return 0;
+}
+
+// --- Arranque y Parada ---
+
+static void free_snapshots(void) {
+    for (int i = 0; i < SNAPSHOT_COUNT; i++) {
+        if (pipeline.slots[i]) {
+            free_entity_pools(&pipeline.slots[i]->state);
+            SDL_free(pipeline.slots[i]);
+            pipeline.slots[i] = NULL;
+        }
+    }
+}
+
+static bool start_pipeline(Game* game) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    for (int i = 0; i < SNAPSHOT_COUNT; i++) {
+        Snapshot* snapshot = SDL_calloc(1, sizeof(Snapshot));
+        pipeline.slots[i] = snapshot;
+        if (!snapshot || !init_entity_pools(&snapshot->state, &game->config.capacities)) {
+            SDL_free(snapshot);
+            pipeline.slots[i] = NULL;
+            free_snapshots();
+            return false;
+        }
+        // Todas empiezan con el estado actual, estrellas fijas incluidas
+        copy_entity_pools(&snapshot->state, game);
+        copy_frame_state(&snapshot->state, game);
+        snapshot->time = now;
+    }
+    pipeline.back = 0;
+    pipeline.front = 1;
+    SDL_SetAtomicInt(&pipeline.middle, 2);
+    SDL_SetAtomicInt(&pipeline.quit, 0);
+    SDL_SetAtomicInt(&pipeline.finished, 0);
+    pipeline.event_count = 0;
+
+    // La simulación se queda con la partida: pools, generadores, grabación...
+    pipeline.sim = SDL_malloc(sizeof(Game));
+    pipeline.input_lock = SDL_CreateMutex();
+    if (pipeline.sim && pipeline.input_lock) {
+        *pipeline.sim = *game;
+        pipeline.thread = SDL_CreateThread(simulation_main, "simulation", pipeline.sim);
+    }
+    if (!pipeline.thread) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Sin hilo para la simulación (%s)", SDL_GetError());
+        SDL_DestroyMutex(pipeline.input_lock);
+        SDL_free(pipeline.sim);
+        pipeline.input_lock = NULL;
+        pipeline.sim = NULL;
+        free_snapshots();
+        return false;
+    }
+    show_snapshot(game, pipeline.slots[pipeline.front]);
+    return true;
+}
+
+static void stop_pipeline(Game* game) {
+    SDL_SetAtomicInt(&pipeline.quit, 1);
+    SDL_WaitThread(pipeline.thread, NULL);
+    pipeline.thread = NULL;
+
+    // 'game' vuelve a ser la partida; se conserva lo que es del principal
+    Game view = *game;
+    *game = *pipeline.sim;
+    game->text_atlas = view.text_atlas;
+    game->frame = view.frame;
+    game->text_cache = view.text_cache;
+    game->hud_score = view.hud_score;
+    game->hud_highscore = view.hud_highscore;
+    game->hud_lives = view.hud_lives;
+    game->fullscreen = view.fullscreen;
+    game->camera = view.camera;
+    game->render_alpha = view.render_alpha;
+    game->running = false;
+
+    SDL_DestroyMutex(pipeline.input_lock);
+    SDL_free(pipeline.sim);
+    pipeline.input_lock = NULL;
+    pipeline.sim = NULL;
+    free_snapshots();
+}
+
+bool run_pipelined(Game* game) {
+    if (game->config.variable_step) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "--pipeline siempre usa paso fijo: se ignora --variable-step");
+    }
+    if (!start_pipeline(game)) {
+        return false;
+    }
+
+    float ticks_per_step = game->sim_dt * (float)SDL_GetPerformanceFrequency();
+    while (game->running && !SDL_GetAtomicInt(&pipeline.finished)) {
+        PROFILE_BEGIN(PROFILE_EVENTS);
+        forward_events(game);
+        PROFILE_END(PROFILE_EVENTS);
+
+        if (acquire_snapshot()) {
+            show_snapshot(game, pipeline.slots[pipeline.front]);
+        }
+        // Se interpola hacia el último paso según el tiempo que ha pasado desde él
+        Uint64 lag = SDL_GetPerformanceCounter() - pipeline.slots[pipeline.front]->time;
+        game->render_alpha = SDL_min((float)lag / ticks_per_step, 1.0f);
+
+        render_game(game);
+        profile_end_frame();
+    }
+
+    stop_pipeline(game);
+    return true;
+}
@@ -0,0 +1,23 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "game.h"
+
+// --- Simulación y Dibujo en Paralelo (--pipeline) ---
+// La simulación pasa a su propio hilo y avanza a paso fijo con su reloj; el
+// principal sólo lee eventos y dibuja. Tras cada tanda de pasos la simulación
+// copia lo que se dibuja en una de tres instantáneas y la intercambia con la
+// del medio sin bloquear (triple búfer); el principal se queda con la más
+// reciente y la dibuja mientras la simulación ya calcula la siguiente, así
+// que un SDL_RenderPresent que espera al vsync no frena la simulación.
+//
+// Las teclas llegan a la simulación por un buzón: el principal atiende el
+// cierre, F3, F4 y F11, y el resto lo aplica la simulación antes de su
+// siguiente paso, sobre el estado que de verdad tiene. Al terminar, 'game'
+// vuelve a tener el estado de la simulación, así que cleanup no cambia.
+
+// Sustituye al bucle principal; vuelve cuando se cierra la ventana o se
+// elige Salir. Devuelve false si no se pudo arrancar (nada ha cambiado).
+bool run_pipelined(Game* game);
+
+#endif // PIPELINE_H
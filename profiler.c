@@ -0,0 +1,278 @@
+#include "profiler.h"
+
+#ifdef ASTEROIDS_PROFILE
+
+#include "batch.h"
+#include "render.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char* zone_names[PROFILE_ZONE_COUNT] = {
+    "frame", "handle_events", "update_game", "update_ship", "update_stars", "update_ufo",
+    "update_bullets", "update_ufo_bullets", "update_asteroids", "update_powerups", "update_particles", "wait_jobs",
+    "check_collisions", "spawn_explosion", "submit_score", "render_game", "render_stars", "render_ship", "render_bullets", "render_ufo",
+    "render_ufo_bullets", "render_powerups", "render_asteroids", "render_particles",
+    "submit_render_list", "draw_text", "SDL_RenderPresent"
+};
+
+// Un bloque medido: evento completo ("ph": "X") de la traza
+typedef struct {
+    Uint64 start;
+    Uint32 duration; // En unidades del contador de rendimiento, saturado
+    Uint32 zone;
+    SDL_ThreadID thread;
+} TraceEvent;
+
+typedef struct {
+    float min_ms;
+    float avg_ms;
+    float p99_ms;
+} ProfileStats;
+
+static struct {
+    SDL_SpinLock lock; // Para pending y trace: con --pipeline también mide el hilo de la simulación
+    Uint64 pending[PROFILE_ZONE_COUNT]; // Acumulado en el fotograma en curso
+    float history[PROFILE_ZONE_COUNT][PROFILE_HISTORY_FRAMES]; // ms por fotograma, circular
+    int head;   // Siguiente hueco del historial
+    int filled; // Fotogramas válidos en el historial
+    ProfileStats stats[PROFILE_ZONE_COUNT]; // Del historial, al último refresco
+    int frames_since_refresh;
+    double max_ms[PROFILE_ZONE_COUNT]; // De toda la ejecución
+    double total_ms[PROFILE_ZONE_COUNT];
+    Uint64 frames;
+    Uint64 last_frame;
+    double ms_per_tick;
+    bool visible;
+    TraceEvent trace[PROFILE_TRACE_EVENTS];
+    Uint64 trace_count; // Eventos registrados desde el arranque; el siguiente va en trace_count % PROFILE_TRACE_EVENTS
+} profiler;
+
+void profile_add(ProfileZone zone, Uint64 start, Uint64 end) {
+    Uint64 ticks = end - start;
+    SDL_ThreadID thread = SDL_GetCurrentThreadID();
+    SDL_LockSpinlock(&profiler.lock);
+    profiler.pending[zone] += ticks;
+    TraceEvent* event = &profiler.trace[profiler.trace_count % PROFILE_TRACE_EVENTS];
+    event->start = start;
+    event->duration = ticks > SDL_MAX_UINT32 ? SDL_MAX_UINT32 : (Uint32)ticks;
+    event->zone = (Uint32)zone;
+    event->thread = thread;
+    profiler.trace_count++;
+    SDL_UnlockSpinlock(&profiler.lock);
+}
+
+static int compare_float(const void* a, const void* b) {
+    float x = *(const float*)a;
+    float y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+static void refresh_stats(void) {
+    int n = profiler.filled;
+    if (n == 0) {
+        return;
+    }
+    float sorted[PROFILE_HISTORY_FRAMES];
+    for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+        double sum = 0.0;
+        for (int i = 0; i < n; i++) {
+            sorted[i] = profiler.history[z][i];
+            sum += sorted[i];
+        }
+        qsort(sorted, n, sizeof(float), compare_float);
+        profiler.stats[z] = (ProfileStats){ sorted[0], (float)(sum / n), sorted[(n * 99) / 100] };
+    }
+    profiler.frames_since_refresh = 0;
+}
+
+void profile_end_frame(void) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (profiler.ms_per_tick == 0.0) {
+        profiler.ms_per_tick = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    }
+    // El primer fotograma no tiene inicio: su duración queda en 0
+    if (profiler.last_frame) {
+        profile_add(PROFILE_FRAME, profiler.last_frame, now);
+    }
+    profiler.last_frame = now;
+
+    Uint64 pending[PROFILE_ZONE_COUNT];
+    SDL_LockSpinlock(&profiler.lock);
+    SDL_memcpy(pending, profiler.pending, sizeof(pending));
+    SDL_memset(profiler.pending, 0, sizeof(profiler.pending));
+    SDL_UnlockSpinlock(&profiler.lock);
+
+    for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+        double ms = (double)pending[z] * profiler.ms_per_tick;
+        profiler.history[z][profiler.head] = (float)ms;
+        profiler.total_ms[z] += ms;
+        if (ms > profiler.max_ms[z]) {
+            profiler.max_ms[z] = ms;
+        }
+    }
+    profiler.head = (profiler.head + 1) % PROFILE_HISTORY_FRAMES;
+    if (profiler.filled < PROFILE_HISTORY_FRAMES) {
+        profiler.filled++;
+    }
+    profiler.frames++;
+
+    // Ordenar el historial cuesta más que medir: sólo cuando se ve
+    if (profiler.visible && ++profiler.frames_since_refresh >= PROFILE_REFRESH_FRAMES) {
+        refresh_stats();
+    }
+}
+
+void profile_toggle_overlay(void) {
+    profiler.visible = !profiler.visible;
+    if (profiler.visible) {
+        refresh_stats();
+    }
+}
+
+void render_profile_overlay(Game* game) {
+    if (!profiler.visible) {
+        return;
+    }
+
+    // Fondo de la tabla y gráfica: una barra por fotograma, del más antiguo al
+    // más reciente, en rojo si se pasa de PROFILE_BUDGET_MS
+    SDL_FColor panel = { 0.0f, 0.0f, 0.0f, 0.7f };
+    SDL_FColor ok = { 0.2f, 0.9f, 0.2f, 1.0f };
+    SDL_FColor slow = { 1.0f, 0.2f, 0.2f, 1.0f };
+    SDL_FColor budget = { 1.0f, 1.0f, 0.0f, 1.0f };
+    float table_height = (PROFILE_ZONE_COUNT + 1) * 12.0f + 8.0f;
+    batch_fill_rect(&game->frame.vectors, &(SDL_FRect){ 6.0f, 36.0f, 436.0f, table_height }, panel);
+
+    float graph_left = 10.0f;
+    float graph_bottom = SCREEN_HEIGHT - 10.0f;
+    float graph_height = 100.0f;
+    float px_per_ms = graph_height / PROFILE_GRAPH_MS;
+    batch_fill_rect(&game->frame.vectors, &(SDL_FRect){ graph_left - 4.0f, graph_bottom - graph_height - 4.0f,
+                                                  PROFILE_HISTORY_FRAMES * 2.0f + 8.0f, graph_height + 8.0f }, panel);
+    int oldest = profiler.filled < PROFILE_HISTORY_FRAMES ? 0 : profiler.head;
+    for (int i = 0; i < profiler.filled; i++) {
+        float ms = profiler.history[PROFILE_FRAME][(oldest + i) % PROFILE_HISTORY_FRAMES];
+        float h = SDL_min(ms, PROFILE_GRAPH_MS) * px_per_ms;
+        SDL_FRect bar = { graph_left + i * 2.0f, graph_bottom - h, 2.0f, h };
+        batch_fill_rect(&game->frame.vectors, &bar, ms > PROFILE_BUDGET_MS ? slow : ok);
+    }
+    float budget_y = graph_bottom - PROFILE_BUDGET_MS * px_per_ms;
+    batch_line(&game->frame.vectors, graph_left, budget_y, graph_left + PROFILE_HISTORY_FRAMES * 2.0f, budget_y, budget);
+
+    // La tabla va a media escala. Todas las líneas miden más de
+    // TEXT_CACHE_MAX_LEN, así que no desalojan el texto del HUD de la caché.
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Color yellow = {255, 255, 0, 255};
+    char line[64];
+    record_scale(&game->frame, 0.5f);
+    SDL_snprintf(line, sizeof(line), "%-18s %7s %7s %7s", "zona (ms)", "min", "media", "p99");
+    record_text(&game->frame, line, 20, 80, yellow);
+    for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+        const ProfileStats* s = &profiler.stats[z];
+        SDL_snprintf(line, sizeof(line), "%-18s %7.3f %7.3f %7.3f", zone_names[z], s->min_ms, s->avg_ms, s->p99_ms);
+        record_text(&game->frame, line, 20, 80 + (z + 1) * 24, white);
+    }
+    record_scale(&game->frame, 1.0f);
+}
+
+static bool ends_with(const char* text, const char* suffix) {
+    size_t text_len = SDL_strlen(text);
+    size_t suffix_len = SDL_strlen(suffix);
+    return text_len >= suffix_len && SDL_strcmp(text + text_len - suffix_len, suffix) == 0;
+}
+
+bool write_profile_report(const char* path) {
+    if (profiler.frames == 0) {
+        return true;
+    }
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo escribir el perfil en %s", path);
+        return false;
+    }
+
+    refresh_stats();
+    bool json = ends_with(path, ".json");
+    if (json) {
+        fprintf(file, "{\n  \"frames\": %llu,\n  \"window\": %d,\n  \"zones\": [\n",
+                (unsigned long long)profiler.frames, profiler.filled);
+    } else {
+        fprintf(file, "zone,frames,window,min_ms,avg_ms,p99_ms,max_ms,total_ms\n");
+    }
+    for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+        const ProfileStats* s = &profiler.stats[z];
+        if (json) {
+            fprintf(file, "    {\"zone\": \"%s\", \"min_ms\": %.4f, \"avg_ms\": %.4f, \"p99_ms\": %.4f, "
+                          "\"max_ms\": %.4f, \"total_ms\": %.3f}%s\n",
+                    zone_names[z], s->min_ms, s->avg_ms, s->p99_ms, profiler.max_ms[z], profiler.total_ms[z],
+                    z + 1 < PROFILE_ZONE_COUNT ? "," : "");
+        } else {
+            fprintf(file, "%s,%llu,%d,%.4f,%.4f,%.4f,%.4f,%.3f\n", zone_names[z], (unsigned long long)profiler.frames,
+                    profiler.filled, s->min_ms, s->avg_ms, s->p99_ms, profiler.max_ms[z], profiler.total_ms[z]);
+        }
+    }
+    if (json) {
+        fprintf(file, "  ]\n}\n");
+    }
+    bool ok = fclose(file) == 0;
+    SDL_Log("Perfil: %llu fotogramas; min/media/p99 de los últimos %d en %s",
+            (unsigned long long)profiler.frames, profiler.filled, path);
+    return ok;
+}
+
+// Desde el hilo principal: sus eventos van a tid 1 y los de cualquier otro
+// hilo (el de la simulación) a tid 2
+bool write_trace(const char* path) {
+    // Se copia el búfer para no tener parado al otro hilo mientras se escribe;
+    // la copia se reserva antes, para que el cerrojo sólo dure lo que la copia
+    TraceEvent* events = SDL_malloc(sizeof(TraceEvent) * PROFILE_TRACE_EVENTS);
+    if (!events) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Sin memoria para la traza (%s)", SDL_GetError());
+        return false;
+    }
+    SDL_LockSpinlock(&profiler.lock);
+    Uint64 count = SDL_min(profiler.trace_count, (Uint64)PROFILE_TRACE_EVENTS);
+    // El más antiguo está en trace_count % PROFILE_TRACE_EVENTS si el búfer ya dio la vuelta
+    size_t first = (size_t)((profiler.trace_count - count) % PROFILE_TRACE_EVENTS);
+    size_t tail = SDL_min((size_t)count, PROFILE_TRACE_EVENTS - first);
+    SDL_memcpy(events, &profiler.trace[first], sizeof(TraceEvent) * tail);
+    SDL_memcpy(events + tail, profiler.trace, sizeof(TraceEvent) * ((size_t)count - tail));
+    SDL_UnlockSpinlock(&profiler.lock);
+    if (count == 0) {
+        SDL_free(events);
+        return true;
+    }
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo escribir la traza en %s", path);
+        SDL_free(events);
+        return false;
+    }
+
+    // Tiempos en microsegundos desde el primer inicio que se conserva. Los
+    // eventos se guardan al terminar, así que una zona que contiene a otras
+    // está detrás de ellas aunque empezara antes.
+    double us_per_tick = 1000000.0 / (double)SDL_GetPerformanceFrequency();
+    Uint64 origin = events[0].start;
+    for (Uint64 i = 0; i < count; i++) {
+        origin = SDL_min(origin, events[i].start);
+    }
+    SDL_ThreadID main_thread = SDL_GetCurrentThreadID();
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    fprintf(file, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"principal\"}},\n");
+    fprintf(file, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 2, \"args\": {\"name\": \"simulación\"}}");
+    for (Uint64 i = 0; i < count; i++) {
+        const TraceEvent* event = &events[i];
+        double ts = ((double)event->start - (double)origin) * us_per_tick;
+        fprintf(file, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d}",
+                zone_names[event->zone], ts, event->duration * us_per_tick, event->thread == main_thread ? 1 : 2);
+    }
+    fprintf(file, "\n]}\n");
+    SDL_free(events);
+    bool ok = fclose(file) == 0;
+    SDL_Log("Traza: %llu eventos en %s", (unsigned long long)count, path);
+    return ok;
+}
+
+#endif // ASTEROIDS_PROFILE
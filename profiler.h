@@ -0,0 +1,84 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "game.h"
+
+// --- Perfilado por Subsistema ---
+// Se compila sólo con ASTEROIDS_PROFILE (make PROFILE=1); sin él, las macros
+// no generan código y las funciones están vacías. PROFILE_BEGIN/PROFILE_END
+// miden un bloque dentro de una misma función y suman el tiempo a su zona;
+// profile_end_frame cierra el fotograma (un paso en modo headless) y guarda
+// lo acumulado en el historial, del que salen mínimo, media y p99 de los
+// últimos PROFILE_HISTORY_FRAMES fotogramas.
+//
+// Además, cada medición queda como un evento en un búfer circular de
+// PROFILE_TRACE_EVENTS (los más antiguos se pisan). write_trace lo vuelca
+// como traza de Chrome (chrome://tracing, ui.perfetto.dev) para ver en una
+// línea de tiempo qué pasó en cada fotograma de los últimos segundos.
+
+typedef enum {
+    PROFILE_FRAME, // Entre dos profile_end_frame; lo rellena el propio perfilador
+    PROFILE_EVENTS,
+    PROFILE_UPDATE, // update_game completo (todos los pasos del fotograma)
+    PROFILE_UPDATE_SHIP,
+    PROFILE_UPDATE_STARS,
+    PROFILE_UPDATE_UFO,
+    PROFILE_UPDATE_BULLETS,
+    PROFILE_UPDATE_UFO_BULLETS,
+    PROFILE_UPDATE_ASTEROIDS,
+    PROFILE_UPDATE_POWERUPS,
+    PROFILE_UPDATE_PARTICLES,
+    // Tramos que hace el hilo que reparte (ver jobs.h) mientras espera a los
+    // demás. Si una pool se reparte, su zona update_* sólo mide lo que cuesta
+    // lanzar los tramos.
+    PROFILE_UPDATE_JOIN,
+    PROFILE_COLLISIONS,
+    PROFILE_EXPLOSION,
+    PROFILE_SUBMIT_SCORE, // Al acabar la partida (la escritura va en otro hilo)
+    PROFILE_RENDER, // render_game completo, sin SDL_RenderPresent
+    // Los render_* sólo graban el fotograma; SDL trabaja en submit_render_list
+    PROFILE_RENDER_STARS,
+    PROFILE_RENDER_SHIP,
+    PROFILE_RENDER_BULLETS,
+    PROFILE_RENDER_UFO,
+    PROFILE_RENDER_UFO_BULLETS,
+    PROFILE_RENDER_POWERUPS,
+    PROFILE_RENDER_ASTEROIDS,
+    PROFILE_RENDER_PARTICLES,
+    PROFILE_RENDER_SUBMIT, // submit_render_list: lo grabado por los render_* pasa al renderizador
+    PROFILE_RENDER_TEXT, // Las órdenes de texto, dentro de submit_render_list
+    PROFILE_PRESENT,
+    PROFILE_ZONE_COUNT
+} ProfileZone;
+
+#ifdef ASTEROIDS_PROFILE
+
+#define PROFILE_BEGIN(zone) Uint64 profile_start_##zone = SDL_GetPerformanceCounter()
+#define PROFILE_END(zone) profile_add(zone, profile_start_##zone, SDL_GetPerformanceCounter())
+
+// Desde el hilo principal o, con --pipeline, desde el de la simulación
+void profile_add(ProfileZone zone, Uint64 start, Uint64 end);
+// El resto, sólo desde el hilo principal
+void profile_end_frame(void);
+void profile_toggle_overlay(void);
+// Gráfica del tiempo por fotograma y tabla de zonas; va encima de todo lo demás
+void render_profile_overlay(Game* game);
+// CSV, o JSON si 'path' acaba en ".json"
+bool write_profile_report(const char* path);
+// Eventos del búfer circular, del más antiguo al más reciente
+bool write_trace(const char* path);
+
+#else
+
+#define PROFILE_BEGIN(zone) ((void)0)
+#define PROFILE_END(zone) ((void)0)
+
+static inline void profile_end_frame(void) {}
+static inline void profile_toggle_overlay(void) {}
+static inline void render_profile_overlay(Game* game) { (void)game; }
+static inline bool write_profile_report(const char* path) { (void)path; return true; }
+static inline bool write_trace(const char* path) { (void)path; return true; }
+
+#endif // ASTEROIDS_PROFILE
+
+#endif // PROFILER_H
@@ -0,0 +1,258 @@
+#include "render.h"
+#include "batch.h"
+#include "profiler.h"
+#include "utils.h"
+#include <stdio.h>
+
+// --- Grabación ---
+
+// Asegura sitio para 'extra' elementos más de 'size' bytes. El array crece al
+// doble cuando se llena; si no hay memoria la orden se descarta.
+static bool reserve(void** items, int* capacity, int count, int extra, size_t size, int initial) {
+    if (count + extra <= *capacity) {
+        return true;
+    }
+    int grown_capacity = SDL_max(SDL_max(*capacity * 2, initial), count + extra);
+    void* grown = SDL_realloc(*items, size * grown_capacity);
+    if (!grown) {
+        return false;
+    }
+    *items = grown;
+    *capacity = grown_capacity;
+    return true;
+}
+
+static RenderCommand* push_command(RenderList* list, RenderCommandType type) {
+    if (!reserve((void**)&list->commands, &list->command_capacity, list->command_count, 1,
+                 sizeof(RenderCommand), RENDER_LIST_INITIAL_COMMANDS)) {
+        return NULL;
+    }
+    RenderCommand* command = &list->commands[list->command_count++];
+    *command = (RenderCommand){ .type = type };
+    return command;
+}
+
+// Lo que se ha añadido al lote desde la última orden GEOMETRY pasa a ser una
+// orden nueva, así que todo lo vectorial entre dos órdenes de otro tipo se une
+static void close_geometry(RenderList* list) {
+    int pending = list->vectors.index_count - list->vectors_recorded;
+    if (pending <= 0) {
+        return;
+    }
+    RenderCommand* command = push_command(list, RENDER_GEOMETRY);
+    if (!command) {
+        return; // Se intentará con la siguiente orden
+    }
+    command->first = list->vectors_recorded;
+    command->count = pending;
+    list->vectors_recorded = list->vectors.index_count;
+}
+
+static RenderCommand* add_command(RenderList* list, RenderCommandType type) {
+    close_geometry(list);
+    return push_command(list, type);
+}
+
+void begin_render_list(RenderList* list) {
+    list->command_count = 0;
+    list->vectors.vertex_count = 0;
+    list->vectors.index_count = 0;
+    list->vectors_recorded = 0;
+    list->point_count = 0;
+    list->rect_count = 0;
+    list->text_length = 0;
+}
+
+void end_render_list(RenderList* list) {
+    close_geometry(list);
+}
+
+void record_clear(RenderList* list, SDL_Color color) {
+    RenderCommand* command = add_command(list, RENDER_CLEAR);
+    if (command) {
+        command->color = color;
+    }
+}
+
+void record_viewport(RenderList* list, float x, float y) {
+    RenderCommand* command = add_command(list, RENDER_VIEWPORT);
+    if (command) {
+        command->x = x;
+        command->y = y;
+    }
+}
+
+void record_scale(RenderList* list, float scale) {
+    RenderCommand* command = add_command(list, RENDER_SCALE);
+    if (command) {
+        command->x = scale;
+        command->y = scale;
+    }
+}
+
+SDL_FPoint* record_points(RenderList* list, int count, SDL_Color color) {
+    if (!reserve((void**)&list->points, &list->point_capacity, list->point_count, count,
+                 sizeof(SDL_FPoint), RENDER_LIST_INITIAL_ITEMS)) {
+        return NULL;
+    }
+    RenderCommand* command = add_command(list, RENDER_POINTS);
+    if (!command) {
+        return NULL;
+    }
+    command->color = color;
+    command->first = list->point_count;
+    command->count = count;
+    list->point_count += count;
+    return &list->points[command->first];
+}
+
+SDL_FRect* record_rects(RenderList* list, int count, SDL_Color color) {
+    if (!reserve((void**)&list->rects, &list->rect_capacity, list->rect_count, count,
+                 sizeof(SDL_FRect), RENDER_LIST_INITIAL_ITEMS)) {
+        return NULL;
+    }
+    RenderCommand* command = add_command(list, RENDER_RECTS);
+    if (!command) {
+        return NULL;
+    }
+    command->color = color;
+    command->first = list->rect_count;
+    command->count = count;
+    list->rect_count += count;
+    return &list->rects[command->first];
+}
+
+void record_text(RenderList* list, const char* text, int x, int y, SDL_Color color) {
+    int length = (int)SDL_strlen(text) + 1;
+    if (!reserve((void**)&list->text, &list->text_capacity, list->text_length, length,
+                 sizeof(char), RENDER_LIST_INITIAL_TEXT)) {
+        return;
+    }
+    RenderCommand* command = add_command(list, RENDER_TEXT);
+    if (!command) {
+        return;
+    }
+    command->color = color;
+    command->first = list->text_length;
+    command->count = length - 1;
+    command->x = (float)x;
+    command->y = (float)y;
+    SDL_memcpy(&list->text[list->text_length], text, length);
+    list->text_length += length;
+}
+
+// --- Reproducción ---
+
+void submit_render_list(Game* game) {
+    const RenderList* list = &game->frame;
+    SDL_Renderer* renderer = game->renderer;
+
+    for (int i = 0; i < list->command_count; i++) {
+        const RenderCommand* command = &list->commands[i];
+        SDL_Color c = command->color;
+        switch (command->type) {
+            case RENDER_CLEAR:
+                SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+                SDL_RenderClear(renderer);
+                break;
+            case RENDER_VIEWPORT:
+                if (command->x != 0.0f || command->y != 0.0f) {
+                    SDL_Rect viewport = { (int)command->x, (int)command->y, SCREEN_WIDTH, SCREEN_HEIGHT };
+                    SDL_SetRenderViewport(renderer, &viewport);
+                } else {
+                    SDL_SetRenderViewport(renderer, NULL);
+                }
+                break;
+            case RENDER_SCALE:
+                SDL_SetRenderScale(renderer, command->x, command->y);
+                break;
+            case RENDER_GEOMETRY:
+                // Los índices son del lote entero: se pasan todos los vértices
+                SDL_RenderGeometry(renderer, NULL, list->vectors.vertices, list->vectors.vertex_count,
+                                   &list->vectors.indices[command->first], command->count);
+                break;
+            case RENDER_POINTS:
+                SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+                SDL_RenderPoints(renderer, &list->points[command->first], command->count);
+                break;
+            case RENDER_RECTS:
+                SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+                SDL_RenderFillRects(renderer, &list->rects[command->first], command->count);
+                break;
+            case RENDER_TEXT: {
+                PROFILE_BEGIN(PROFILE_RENDER_TEXT);
+                draw_text(game, &list->text[command->first], (int)command->x, (int)command->y, c);
+                PROFILE_END(PROFILE_RENDER_TEXT);
+                break;
+            }
+        }
+    }
+}
+
+// --- Volcado ---
+
+// FNV-1a, acumulando sobre 'hash'
+static Uint32 hash_bytes(Uint32 hash, const void* data, size_t size) {
+    const Uint8* bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+bool write_render_list(const RenderList* list, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo escribir el fotograma en %s", path);
+        return false;
+    }
+
+    for (int i = 0; i < list->command_count; i++) {
+        const RenderCommand* command = &list->commands[i];
+        SDL_Color c = command->color;
+        Uint32 hash = 2166136261u;
+        switch (command->type) {
+            case RENDER_CLEAR:
+                fprintf(file, "clear %d %d %d %d\n", c.r, c.g, c.b, c.a);
+                break;
+            case RENDER_VIEWPORT:
+                fprintf(file, "viewport %.0f %.0f\n", command->x, command->y);
+                break;
+            case RENDER_SCALE:
+                fprintf(file, "scale %.2f %.2f\n", command->x, command->y);
+                break;
+            case RENDER_GEOMETRY:
+                // Los vértices en el orden en que se usan, no en el del lote
+                for (int k = 0; k < command->count; k++) {
+                    const SDL_Vertex* v = &list->vectors.vertices[list->vectors.indices[command->first + k]];
+                    hash = hash_bytes(hash, v, sizeof(SDL_Vertex));
+                }
+                fprintf(file, "geometry %d %08x\n", command->count / 3, hash);
+                break;
+            case RENDER_POINTS:
+                hash = hash_bytes(hash, &list->points[command->first], sizeof(SDL_FPoint) * command->count);
+                fprintf(file, "points %d %d %d %d %d %08x\n", command->count, c.r, c.g, c.b, c.a, hash);
+                break;
+            case RENDER_RECTS:
+                hash = hash_bytes(hash, &list->rects[command->first], sizeof(SDL_FRect) * command->count);
+                fprintf(file, "rects %d %d %d %d %d %08x\n", command->count, c.r, c.g, c.b, c.a, hash);
+                break;
+            case RENDER_TEXT:
+                fprintf(file, "text %.0f %.0f %d %d %d %d \"%s\"\n", command->x, command->y, c.r, c.g, c.b, c.a,
+                        &list->text[command->first]);
+                break;
+        }
+    }
+    bool ok = fclose(file) == 0;
+    SDL_Log("Fotograma: %d órdenes en %s", list->command_count, path);
+    return ok;
+}
+
+void destroy_render_list(RenderList* list) {
+    destroy_vector_batch(&list->vectors);
+    SDL_free(list->commands);
+    SDL_free(list->points);
+    SDL_free(list->rects);
+    SDL_free(list->text);
+    *list = (RenderList){0};
+}
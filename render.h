@@ -0,0 +1,39 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "game.h"
+
+// --- Lista de Dibujo ---
+// Los render_* no llaman a SDL: graban el fotograma en game->frame como una
+// lista de órdenes (borrar, temblor, escala, geometría vectorial, puntos,
+// rectángulos y texto) y submit_render_list la reproduce después con el
+// renderizador. Grabar no necesita ventana ni renderizador, y el fotograma
+// queda entero en memoria hasta el siguiente: write_render_list lo vuelca
+// como texto para comparar dos fotogramas.
+//
+// Lo que se añade al lote vectorial con batch_* entre dos órdenes de otro
+// tipo queda en una sola orden GEOMETRY, que se envía con un solo
+// SDL_RenderGeometry. El orden de las órdenes es el de dibujo.
+
+// Vacía la lista (conserva la memoria) para grabar un fotograma nuevo
+void begin_render_list(RenderList* list);
+// Cierra la última orden GEOMETRY; se llama antes de reproducir o volcar
+void end_render_list(RenderList* list);
+
+void record_clear(RenderList* list, SDL_Color color);
+void record_viewport(RenderList* list, float x, float y);
+void record_scale(RenderList* list, float scale);
+// Reservan 'count' elementos que rellena el llamador; NULL si no hay memoria
+SDL_FPoint* record_points(RenderList* list, int count, SDL_Color color);
+SDL_FRect* record_rects(RenderList* list, int count, SDL_Color color);
+// La cadena se copia: puede ser un búfer temporal del llamador
+void record_text(RenderList* list, const char* text, int x, int y, SDL_Color color);
+
+// Dibuja game->frame con game->renderer (el texto, con la caché de draw_text)
+void submit_render_list(Game* game);
+// Una línea por orden; la geometría, los puntos y los rectángulos van
+// resumidos con un hash de sus datos
+bool write_render_list(const RenderList* list, const char* path);
+void destroy_render_list(RenderList* list);
+
+#endif // RENDER_H
@@ -0,0 +1,204 @@
+#include "replay.h"
+#include "entities.h"
+#include "rng.h"
+
+// --- Formato ---
+// Cabecera en little endian: "ASTR", versión, semilla, tick rate y las cinco
+// capacidades. Después, tramos de dos bytes (entrada, pasos): de 1 a 255
+// pasos seguidos con la misma entrada. Las teclas se mantienen pulsadas
+// durante muchos pasos, así que un minuto de partida ocupa unos pocos KB.
+
+#define REPLAY_MAGIC 0x52545341u // "ASTR"
+#define REPLAY_VERSION 2 // 2: coordenadas del mundo (las grabaciones anteriores darían otras partidas)
+#define REPLAY_MAX_RUN 255
+
+enum {
+    REPLAY_THRUST = 1 << 0,
+    REPLAY_TURN_LEFT = 1 << 1,
+    REPLAY_TURN_RIGHT = 1 << 2,
+    REPLAY_FIRE = 1 << 3,
+    REPLAY_HYPERSPACE = 1 << 4,
+    REPLAY_PAUSED = 1 << 5,   // Paso en pausa: no se simula
+    REPLAY_NEW_GAME = 1 << 6, // Empieza una partida justo antes del paso
+};
+
+static bool write_header(SDL_IOStream* io, const Config* config) {
+    const PoolCapacities* c = &config->capacities;
+    return SDL_WriteU32LE(io, REPLAY_MAGIC) && SDL_WriteU32LE(io, REPLAY_VERSION) &&
+           SDL_WriteU64LE(io, config->seed) && SDL_WriteU32LE(io, (Uint32)config->tick_rate) &&
+           SDL_WriteU32LE(io, (Uint32)c->bullets) && SDL_WriteU32LE(io, (Uint32)c->asteroids) &&
+           SDL_WriteU32LE(io, (Uint32)c->powerups) && SDL_WriteU32LE(io, (Uint32)c->stars) &&
+           SDL_WriteU32LE(io, (Uint32)c->particles);
+}
+
+static bool read_header(SDL_IOStream* io, Config* config) {
+    Uint32 magic, version, tick_rate, capacities[5];
+    Uint64 seed;
+    if (!SDL_ReadU32LE(io, &magic) || !SDL_ReadU32LE(io, &version) || magic != REPLAY_MAGIC || version != REPLAY_VERSION ||
+        !SDL_ReadU64LE(io, &seed) || !SDL_ReadU32LE(io, &tick_rate)) {
+        return false;
+    }
+    for (int i = 0; i < 5; i++) {
+        if (!SDL_ReadU32LE(io, &capacities[i])) {
+            return false;
+        }
+    }
+    config->seed = seed;
+    config->tick_rate = (int)tick_rate;
+    config->capacities = (PoolCapacities){
+        (int)capacities[0], (int)capacities[1], (int)capacities[2], (int)capacities[3], (int)capacities[4]
+    };
+    return tick_rate > 0;
+}
+
+// --- Grabación ---
+
+bool start_recording(Game* game, const char* path) {
+    SDL_IOStream* io = SDL_IOFromFile(path, "wb");
+    if (!io) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo crear la grabación '%s': %s", path, SDL_GetError());
+        return false;
+    }
+    if (!write_header(io, &game->config)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo escribir la grabación '%s': %s", path, SDL_GetError());
+        SDL_CloseIO(io);
+        return false;
+    }
+    game->recording = (Recording){ .file = io };
+    return true;
+}
+
+// Escribe el tramo en curso; si falla se deja de grabar
+static bool flush_run(Recording* recording) {
+    if (recording->run == 0) {
+        return true;
+    }
+    if (!SDL_WriteU8(recording->file, recording->flags) || !SDL_WriteU8(recording->file, (Uint8)recording->run)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Grabación interrumpida: %s", SDL_GetError());
+        SDL_CloseIO(recording->file);
+        *recording = (Recording){0};
+        return false;
+    }
+    recording->run = 0;
+    return true;
+}
+
+void record_tick(Game* game) {
+    Recording* recording = &game->recording;
+    const InputState* input = &game->input;
+    Uint8 flags = 0;
+    if (game->state == GAME_STATE_PAUSED) {
+        flags = REPLAY_PAUSED;
+    } else if (game->state == GAME_STATE_PLAYING) {
+        if (input->thrust) flags |= REPLAY_THRUST;
+        if (input->turn_left) flags |= REPLAY_TURN_LEFT;
+        if (input->turn_right) flags |= REPLAY_TURN_RIGHT;
+        if (input->fire) flags |= REPLAY_FIRE;
+        if (input->hyperspace) flags |= REPLAY_HYPERSPACE;
+        if (input->new_game) {
+            flags |= REPLAY_NEW_GAME;
+            recording->games++;
+        }
+    } else {
+        return; // Menú o fin de partida: no hay nada que simular
+    }
+
+    if (recording->run > 0 && (flags != recording->flags || recording->run == REPLAY_MAX_RUN)) {
+        if (!flush_run(recording)) {
+            return;
+        }
+    }
+    recording->flags = flags;
+    recording->run++;
+    recording->ticks++;
+}
+
+void stop_recording(Game* game) {
+    Recording* recording = &game->recording;
+    if (!recording->file) {
+        return;
+    }
+    Uint64 ticks = recording->ticks;
+    if (flush_run(recording)) {
+        if (!SDL_CloseIO(recording->file)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo cerrar la grabación: %s", SDL_GetError());
+        }
+        *recording = (Recording){0};
+    }
+    SDL_Log("Grabación: %llu pasos", (unsigned long long)ticks);
+}
+
+// --- Reproducción ---
+
+static void log_replay_game(const Game* game, int index) {
+    SDL_Log("Replay: partida %d: puntuación %d, nivel %d, vidas %d", index, game->score, game->level, game->lives);
+}
+
+bool run_replay(Game* game) {
+    const char* path = game->config.replay_path;
+    SDL_IOStream* io = SDL_IOFromFile(path, "rb");
+    if (!io) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo abrir la grabación '%s': %s", path, SDL_GetError());
+        return false;
+    }
+    if (!read_header(io, &game->config)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "'%s' no es una grabación válida", path);
+        SDL_CloseIO(io);
+        return false;
+    }
+
+    // La partida depende de estos valores, así que mandan los de la grabación
+    game->sim_dt = 1.0f / (float)game->config.tick_rate;
+    seed_game_rngs(game, game->config.seed);
+    if (!init_entity_pools(game, &game->config.capacities)) {
+        SDL_CloseIO(io);
+        return false;
+    }
+    init_game_state(game);
+    SDL_Log("Replay: semilla %llu, %d pasos/s", (unsigned long long)game->config.seed, game->config.tick_rate);
+
+    Uint64 ticks = 0;
+    Uint64 paused_ticks = 0;
+    int games = 0;
+    Uint8 flags, run;
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    while (SDL_ReadU8(io, &flags) && SDL_ReadU8(io, &run)) {
+        for (int i = 0; i < run; i++) {
+            if (flags & REPLAY_PAUSED) {
+                paused_ticks++;
+                continue;
+            }
+            if (flags & REPLAY_NEW_GAME) {
+                if (games > 0) {
+                    log_replay_game(game, games);
+                }
+                start_new_game(game);
+                start_level(game);
+                games++;
+            }
+
+            game->input.thrust = (flags & REPLAY_THRUST) != 0;
+            game->input.turn_left = (flags & REPLAY_TURN_LEFT) != 0;
+            game->input.turn_right = (flags & REPLAY_TURN_RIGHT) != 0;
+            game->input.fire = (flags & REPLAY_FIRE) != 0;
+            game->input.hyperspace = (flags & REPLAY_HYPERSPACE) != 0;
+            if (game->state == GAME_STATE_PLAYING) {
+                update_playing(game, game->sim_dt);
+            }
+            ticks++;
+        }
+    }
+    SDL_CloseIO(io);
+
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    if (seconds <= 0.0) seconds = 1e-9;
+
+    if (games > 0) {
+        log_replay_game(game, games);
+    }
+    SDL_Log("Replay: %d partidas, %llu pasos (%llu en pausa) en %.3f s reales, %.0f pasos/s",
+            games, (unsigned long long)ticks, (unsigned long long)paused_ticks, seconds, ticks / seconds);
+    log_pool_usage(game);
+    return true;
+}
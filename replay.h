@@ -0,0 +1,21 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "game.h"
+
+// --- Grabación y Reproducción de Partidas ---
+// Con --record se guarda la entrada de cada paso de simulación junto con la
+// semilla, el tick rate y las capacidades de las pools, que es todo lo que
+// decide una partida. --replay la vuelve a simular sin ventana a toda
+// velocidad, así que reproduce exactamente las mismas partidas.
+
+bool start_recording(Game* game, const char* path);
+// Lo llama update_game en cada paso; sólo cuentan los pasos jugados o en pausa
+void record_tick(Game* game);
+void stop_recording(Game* game);
+
+// Lee config.replay_path, ajusta la configuración a la de la grabación,
+// prepara las pools y simula todos sus pasos
+bool run_replay(Game* game);
+
+#endif // REPLAY_H
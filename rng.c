@@ -0,0 +1,38 @@
+#include "rng.h"
+
+// Flujos de PCG: misma semilla, secuencias independientes
+#define RNG_STREAM_SIM 1
+#define RNG_STREAM_FX 2
+
+void rng_seed(Rng* rng, Uint64 seed, Uint64 stream) {
+    // Secuencia de inicialización de referencia de PCG
+    rng->state = 0;
+    rng->inc = (stream << 1) | 1; // El incremento tiene que ser impar
+    rng_next(rng);
+    rng->state += seed;
+    rng_next(rng);
+}
+
+Uint32 rng_next(Rng* rng) {
+    Uint64 old = rng->state;
+    rng->state = old * 6364136223846793005ULL + rng->inc;
+    // Salida XSH RR: xorshift de los bits altos y rotación según los 5 más altos
+    Uint32 xorshifted = (Uint32)(((old >> 18) ^ old) >> 27);
+    Uint32 rot = (Uint32)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+float rng_float(Rng* rng) {
+    // Los 24 bits altos caben exactos en la mantisa de un float
+    return (float)(rng_next(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+int rng_int(Rng* rng, int bound) {
+    // Multiplicar y quedarse con la parte alta evita la división de '%'
+    return (int)(((Uint64)rng_next(rng) * (Uint32)bound) >> 32);
+}
+
+void seed_game_rngs(Game* game, Uint64 seed) {
+    rng_seed(&game->sim_rng, seed, RNG_STREAM_SIM);
+    rng_seed(&game->fx_rng, seed, RNG_STREAM_FX);
+}
@@ -0,0 +1,22 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include "game.h"
+
+// --- Generador de Números Aleatorios ---
+// PCG32: 64 bits de estado, salida de 32 bits. Cada Game tiene dos flujos
+// independientes sembrados con la misma semilla: sim_rng para todo lo que
+// afecta a la partida y fx_rng para lo puramente visual. Así los efectos que
+// dependen de los fotogramas dibujados no alteran la simulación y una misma
+// semilla reproduce siempre la misma partida.
+
+// Hay que sembrar un Rng antes de usarlo; uno a cero sólo devuelve ceros
+void rng_seed(Rng* rng, Uint64 seed, Uint64 stream);
+Uint32 rng_next(Rng* rng);
+float rng_float(Rng* rng);       // En [0, 1)
+int rng_int(Rng* rng, int bound); // En [0, bound), bound > 0
+
+// Siembra sim_rng y fx_rng del juego a partir de una sola semilla
+void seed_game_rngs(Game* game, Uint64 seed);
+
+#endif // RNG_H
@@ -0,0 +1,342 @@
+#include "scores.h"
+#include <stdio.h>
+
+// --- Formato de leaderboard.dat ---
+// Todo en little endian.
+//   Cabecera:  "ASLB", versión, LEADERBOARD_SIZE, tamaño de registro
+//   Índice A y B: secuencia (u64), entradas (u32), suma de control (u32) y
+//              LEADERBOARD_SIZE registros. Vale la copia correcta con la
+//              secuencia más alta; cada escritura pisa la otra.
+//   Historial: un registro por partida terminada, en orden.
+// Registro: puntuación, nivel, fecha (u64), partida de la grabación,
+// reservado, nombre y grabación.
+
+#define SCORES_MAGIC 0x424C5341u // "ASLB"
+#define SCORES_VERSION 1
+#define SCORES_HEADER_SIZE 16
+#define SCORES_RECORD_SIZE (24 + LEADERBOARD_NAME_SIZE + LEADERBOARD_REPLAY_SIZE)
+#define SCORES_INDEX_SIZE (16 + LEADERBOARD_SIZE * SCORES_RECORD_SIZE)
+#define SCORES_HISTORY_OFFSET (SCORES_HEADER_SIZE + 2 * SCORES_INDEX_SIZE)
+#define SCORES_PENDING 16 // Partidas que pueden esperar a ser escritas
+
+static void put_u32(Uint8* p, Uint32 v) {
+    p[0] = (Uint8)v; p[1] = (Uint8)(v >> 8); p[2] = (Uint8)(v >> 16); p[3] = (Uint8)(v >> 24);
+}
+
+static void put_u64(Uint8* p, Uint64 v) {
+    put_u32(p, (Uint32)v);
+    put_u32(p + 4, (Uint32)(v >> 32));
+}
+
+static Uint32 get_u32(const Uint8* p) {
+    return (Uint32)p[0] | ((Uint32)p[1] << 8) | ((Uint32)p[2] << 16) | ((Uint32)p[3] << 24);
+}
+
+static Uint64 get_u64(const Uint8* p) {
+    return (Uint64)get_u32(p) | ((Uint64)get_u32(p + 4) << 32);
+}
+
+// FNV-1a de 32 bits
+static Uint32 checksum(const Uint8* data, size_t size) {
+    Uint32 hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void pack_entry(Uint8* p, const ScoreEntry* entry) {
+    SDL_memset(p, 0, SCORES_RECORD_SIZE);
+    put_u32(p, (Uint32)entry->score);
+    put_u32(p + 4, (Uint32)entry->level);
+    put_u64(p + 8, (Uint64)entry->date);
+    put_u32(p + 16, (Uint32)entry->replay_game);
+    SDL_memcpy(p + 24, entry->name, LEADERBOARD_NAME_SIZE);
+    SDL_memcpy(p + 24 + LEADERBOARD_NAME_SIZE, entry->replay, LEADERBOARD_REPLAY_SIZE);
+}
+
+static void unpack_entry(const Uint8* p, ScoreEntry* entry) {
+    entry->score = (int)get_u32(p);
+    entry->level = (int)get_u32(p + 4);
+    entry->date = (SDL_Time)get_u64(p + 8);
+    entry->replay_game = (int)get_u32(p + 16);
+    SDL_memcpy(entry->name, p + 24, LEADERBOARD_NAME_SIZE);
+    SDL_memcpy(entry->replay, p + 24 + LEADERBOARD_NAME_SIZE, LEADERBOARD_REPLAY_SIZE);
+    entry->name[LEADERBOARD_NAME_SIZE - 1] = '\0';
+    entry->replay[LEADERBOARD_REPLAY_SIZE - 1] = '\0';
+}
+
+static void pack_index(Uint8* p, const Leaderboard* board) {
+    SDL_memset(p, 0, SCORES_INDEX_SIZE);
+    put_u64(p, board->sequence);
+    put_u32(p + 8, (Uint32)board->count);
+    for (int i = 0; i < board->count; i++) {
+        pack_entry(p + 16 + i * SCORES_RECORD_SIZE, &board->entries[i]);
+    }
+    put_u32(p + 12, checksum(p + 16, SCORES_INDEX_SIZE - 16) ^ (Uint32)board->sequence);
+}
+
+// false si la copia está a medio escribir o no es de este formato
+static bool unpack_index(const Uint8* p, Leaderboard* board) {
+    Uint64 sequence = get_u64(p);
+    Uint32 count = get_u32(p + 8);
+    if (count > LEADERBOARD_SIZE || get_u32(p + 12) != (checksum(p + 16, SCORES_INDEX_SIZE - 16) ^ (Uint32)sequence)) {
+        return false;
+    }
+    board->sequence = sequence;
+    board->count = (int)count;
+    for (int i = 0; i < board->count; i++) {
+        unpack_entry(p + 16 + i * SCORES_RECORD_SIZE, &board->entries[i]);
+    }
+    return true;
+}
+
+// Copia del índice (0 o 1) con la tabla vigente; -1 si no hay ninguna. La
+// fija load_leaderboard y la actualiza cada escritura, que va a la otra.
+static int newest_index = -1;
+
+static Sint64 index_offset(int slot) {
+    return SCORES_HEADER_SIZE + (Sint64)slot * SCORES_INDEX_SIZE;
+}
+
+// --- Carga ---
+
+// highscore.txt de versiones anteriores: "puntuación nivel fecha" por línea
+static void import_legacy(Leaderboard* board) {
+    FILE* file = fopen(LEADERBOARD_LEGACY_FILE, "r");
+    if (!file) {
+        return;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), file)) {
+        ScoreEntry entry = {0};
+        long long date = 0;
+        if (sscanf(line, "%d %d %lld", &entry.score, &entry.level, &date) >= 1) {
+            entry.date = (SDL_Time)date;
+            SDL_strlcpy(entry.name, "---", sizeof(entry.name)); // El formato anterior no guardaba nombres
+            insert_score(board, &entry);
+        }
+    }
+    fclose(file);
+    SDL_Log("Récords: importados %d de %s", board->count, LEADERBOARD_LEGACY_FILE);
+}
+
+void load_leaderboard(Leaderboard* board) {
+    *board = (Leaderboard){0};
+    newest_index = -1;
+    SDL_IOStream* io = SDL_IOFromFile(LEADERBOARD_FILE, "rb");
+    if (!io) {
+        import_legacy(board);
+        return;
+    }
+
+    Uint8 header[SCORES_HEADER_SIZE];
+    Uint8 index[2][SCORES_INDEX_SIZE];
+    bool ok = SDL_ReadIO(io, header, sizeof(header)) == sizeof(header) &&
+              get_u32(header) == SCORES_MAGIC && get_u32(header + 4) == SCORES_VERSION &&
+              get_u32(header + 8) == LEADERBOARD_SIZE && get_u32(header + 12) == SCORES_RECORD_SIZE &&
+              SDL_ReadIO(io, index, sizeof(index)) == sizeof(index);
+    Sint64 size = SDL_GetIOSize(io);
+    SDL_CloseIO(io);
+    if (!ok) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s no es una tabla de récords válida; no se usará", LEADERBOARD_FILE);
+        board->broken = true;
+        return;
+    }
+
+    Leaderboard copies[2] = {0};
+    bool valid[2] = { unpack_index(index[0], &copies[0]), unpack_index(index[1], &copies[1]) };
+    if (valid[0] && (!valid[1] || copies[0].sequence > copies[1].sequence)) {
+        *board = copies[0];
+        newest_index = 0;
+    } else if (valid[1]) {
+        *board = copies[1];
+        newest_index = 1;
+    }
+    Sint64 games = size > SCORES_HISTORY_OFFSET ? (size - SCORES_HISTORY_OFFSET) / SCORES_RECORD_SIZE : 0;
+    SDL_Log("Récords: %d en la tabla, %lld partidas en el historial", board->count, (long long)games);
+}
+
+int insert_score(Leaderboard* board, const ScoreEntry* entry) {
+    if (entry->score <= 0) {
+        return -1;
+    }
+    // Con empate gana la entrada más antigua
+    int pos = 0;
+    while (pos < board->count && board->entries[pos].score >= entry->score) {
+        pos++;
+    }
+    if (pos >= LEADERBOARD_SIZE) {
+        return -1;
+    }
+    if (board->count < LEADERBOARD_SIZE) {
+        board->count++;
+    }
+    SDL_memmove(&board->entries[pos + 1], &board->entries[pos], sizeof(ScoreEntry) * (board->count - 1 - pos));
+    board->entries[pos] = *entry;
+    board->sequence++;
+    board->unsaved = true;
+    return pos;
+}
+
+// --- Escritura en Segundo Plano ---
+// Un único hilo que duerme hasta que hay algo pendiente: las partidas por
+// añadir al historial, en orden, y la última versión del índice.
+
+static struct {
+    SDL_Thread* thread;
+    SDL_Mutex* lock;
+    SDL_Condition* wake;
+    ScoreEntry pending[SCORES_PENDING];
+    int pending_count;
+    Leaderboard board;
+    bool has_board;
+    bool quit;
+} saver;
+
+static SDL_IOStream* open_for_update(void) {
+    SDL_IOStream* io = SDL_IOFromFile(LEADERBOARD_FILE, "r+b");
+    if (io) {
+        return io;
+    }
+    // No existe: cabecera y dos índices vacíos
+    io = SDL_IOFromFile(LEADERBOARD_FILE, "w+b");
+    if (!io) {
+        return NULL;
+    }
+    Uint8 header[SCORES_HEADER_SIZE];
+    Uint8 empty[SCORES_INDEX_SIZE];
+    put_u32(header, SCORES_MAGIC);
+    put_u32(header + 4, SCORES_VERSION);
+    put_u32(header + 8, LEADERBOARD_SIZE);
+    put_u32(header + 12, SCORES_RECORD_SIZE);
+    pack_index(empty, &(Leaderboard){0});
+    if (SDL_WriteIO(io, header, sizeof(header)) != sizeof(header) ||
+        SDL_WriteIO(io, empty, sizeof(empty)) != sizeof(empty) ||
+        SDL_WriteIO(io, empty, sizeof(empty)) != sizeof(empty)) {
+        SDL_CloseIO(io);
+        return NULL;
+    }
+    return io;
+}
+
+static void write_pending(const ScoreEntry* entries, int count, const Leaderboard* board) {
+    SDL_IOStream* io = open_for_update();
+    if (!io) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo guardar la tabla de récords: %s", SDL_GetError());
+        return;
+    }
+
+    // Un registro a medio escribir al final (se cortó la luz) se pisa con el siguiente
+    Sint64 size = SDL_SeekIO(io, 0, SDL_IO_SEEK_END);
+    bool ok = size >= SCORES_HISTORY_OFFSET;
+    if (ok) {
+        Sint64 games = (size - SCORES_HISTORY_OFFSET) / SCORES_RECORD_SIZE;
+        ok = SDL_SeekIO(io, SCORES_HISTORY_OFFSET + games * SCORES_RECORD_SIZE, SDL_IO_SEEK_SET) >= 0;
+    }
+    for (int i = 0; ok && i < count; i++) {
+        Uint8 record[SCORES_RECORD_SIZE];
+        pack_entry(record, &entries[i]);
+        ok = SDL_WriteIO(io, record, sizeof(record)) == sizeof(record);
+    }
+    // El índice va después del historial y en la copia que no es la vigente: si
+    // se corta antes de terminar, la tabla anterior sigue valiendo
+    int slot = newest_index == 0 ? 1 : 0;
+    if (ok && board) {
+        Uint8 index[SCORES_INDEX_SIZE];
+        pack_index(index, board);
+        ok = SDL_SeekIO(io, index_offset(slot), SDL_IO_SEEK_SET) >= 0 &&
+             SDL_WriteIO(io, index, sizeof(index)) == sizeof(index);
+    }
+    ok = SDL_FlushIO(io) && ok;
+    ok = SDL_CloseIO(io) && ok;
+    if (ok && board) {
+        newest_index = slot;
+    }
+    if (!ok) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No se pudo guardar la tabla de récords: %s", SDL_GetError());
+    }
+}
+
+static int SDLCALL saver_main(void* data) {
+    (void)data;
+    SDL_LockMutex(saver.lock);
+    for (;;) {
+        while (saver.pending_count == 0 && !saver.has_board && !saver.quit) {
+            SDL_WaitCondition(saver.wake, saver.lock);
+        }
+        if (saver.pending_count == 0 && !saver.has_board) {
+            break; // Se pidió salir y no queda nada por escribir
+        }
+        ScoreEntry entries[SCORES_PENDING];
+        int count = saver.pending_count;
+        SDL_memcpy(entries, saver.pending, sizeof(ScoreEntry) * count);
+        Leaderboard board = saver.board;
+        bool has_board = saver.has_board;
+        saver.pending_count = 0;
+        saver.has_board = false;
+        SDL_UnlockMutex(saver.lock);
+        write_pending(entries, count, has_board ? &board : NULL);
+        SDL_LockMutex(saver.lock);
+    }
+    SDL_UnlockMutex(saver.lock);
+    return 0;
+}
+
+static bool start_saver(void) {
+    saver.lock = SDL_CreateMutex();
+    saver.wake = SDL_CreateCondition();
+    if (saver.lock && saver.wake) {
+        saver.thread = SDL_CreateThread(saver_main, "leaderboard", NULL);
+    }
+    if (!saver.thread) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Sin hilo para guardar récords (%s); se guardarán al momento", SDL_GetError());
+        SDL_DestroyCondition(saver.wake);
+        SDL_DestroyMutex(saver.lock);
+        saver.wake = NULL;
+        saver.lock = NULL;
+        return false;
+    }
+    return true;
+}
+
+void save_score_async(Leaderboard* board, const ScoreEntry* entry) {
+    if (board->broken) {
+        return; // No se pisa un archivo que no se ha podido leer
+    }
+    bool board_changed = board->unsaved;
+    board->unsaved = false;
+    if (!saver.thread && !start_saver()) {
+        write_pending(entry, 1, board_changed ? board : NULL);
+        return;
+    }
+    SDL_LockMutex(saver.lock);
+    if (saver.pending_count < SCORES_PENDING) {
+        saver.pending[saver.pending_count++] = *entry;
+    } else {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Récords: el disco no da abasto; la partida no irá al historial");
+    }
+    if (board_changed) {
+        saver.board = *board;
+        saver.has_board = true;
+    }
+    SDL_SignalCondition(saver.wake);
+    SDL_UnlockMutex(saver.lock);
+}
+
+void shutdown_leaderboard_saver(void) {
+    if (!saver.thread) {
+        return;
+    }
+    SDL_LockMutex(saver.lock);
+    saver.quit = true;
+    SDL_SignalCondition(saver.wake);
+    SDL_UnlockMutex(saver.lock);
+    SDL_WaitThread(saver.thread, NULL);
+    SDL_DestroyCondition(saver.wake);
+    SDL_DestroyMutex(saver.lock);
+    saver.thread = NULL;
+    saver.wake = NULL;
+    saver.lock = NULL;
+    saver.quit = false;
+}
@@ -0,0 +1,26 @@
+#ifndef SCORES_H
+#define SCORES_H
+
+#include "game.h"
+
+// --- Tabla de Récords ---
+// leaderboard.dat guarda la tabla (el índice) en una posición fija al
+// principio del archivo y detrás el historial de todas las partidas, que sólo
+// crece. Cargar lee únicamente la cabecera y el índice, así que cuesta lo
+// mismo con diez partidas que con un millón. Guardar añade la partida al
+// final y reescribe sólo el índice, en una de sus dos copias: la otra sigue
+// intacta si la escritura se corta.
+//
+// La escritura la hace un hilo en segundo plano: el bucle principal nunca
+// espera al disco.
+
+void load_leaderboard(Leaderboard* board);
+// Devuelve la posición (0 = primera) o -1 si no entra en la tabla
+int insert_score(Leaderboard* board, const ScoreEntry* entry);
+// Añade 'entry' al historial y, si la tabla ha cambiado desde la última vez
+// (o se acaba de importar), también el índice
+void save_score_async(Leaderboard* board, const ScoreEntry* entry);
+// Espera a que se escriba lo pendiente y termina el hilo (al salir)
+void shutdown_leaderboard_saver(void);
+
+#endif // SCORES_H
@@ -1,16 +1,202 @@
 #include "utils.h"
 
+// --- Atlas de Texto ---
+
+static void fill_quad_indices(int* indices, int quads) {
+    for (int i = 0; i < quads; i++) {
+        int base = i * 4;
+        int* idx = &indices[i * 6];
+        idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+        idx[3] = base; idx[4] = base + 2; idx[5] = base + 3;
+    }
+}
+
+bool init_text_atlas(Game* game) {
+    TextAtlas* atlas = &game->text_atlas;
+    SDL_Color white = {255, 255, 255, 255};
+
+    // Press Start 2P es monoespaciada: todas las celdas del atlas miden lo mismo
+    int cell_w = 0;
+    int cell_h = TTF_GetFontHeight(game->font);
+    for (int i = 0; i < TEXT_GLYPH_COUNT; i++) {
+        int advance = 0;
+        if (TTF_GetGlyphMetrics(game->font, TEXT_FIRST_CHAR + i, NULL, NULL, NULL, NULL, &advance) && advance > cell_w) {
+            cell_w = advance;
+        }
+    }
+    if (cell_w <= 0 || cell_h <= 0) {
+        return false;
+    }
+
+    int rows = (TEXT_GLYPH_COUNT + TEXT_ATLAS_COLUMNS - 1) / TEXT_ATLAS_COLUMNS;
+    SDL_Surface* sheet = SDL_CreateSurface(cell_w * TEXT_ATLAS_COLUMNS, cell_h * rows, SDL_PIXELFORMAT_RGBA32);
+    if (!sheet) {
+        return false;
+    }
+    SDL_FillSurfaceRect(sheet, NULL, SDL_MapSurfaceRGBA(sheet, 0, 0, 0, 0));
+
+    for (int i = 0; i < TEXT_GLYPH_COUNT; i++) {
+        SDL_Rect cell = { (i % TEXT_ATLAS_COLUMNS) * cell_w, (i / TEXT_ATLAS_COLUMNS) * cell_h, 0, 0 };
+        atlas->src[i] = (SDL_FRect){ (float)cell.x, (float)cell.y, 0.0f, 0.0f };
+        atlas->advance[i] = (float)cell_w;
+
+        // Los glifos se rasterizan en blanco; el color se aplica por vértice al dibujar
+        SDL_Surface* glyph = TTF_RenderGlyph_Solid(game->font, TEXT_FIRST_CHAR + i, white);
+        if (!glyph) {
+            continue; // El espacio puede no tener imagen
+        }
+        cell.w = SDL_min(glyph->w, cell_w);
+        cell.h = SDL_min(glyph->h, cell_h);
+        SDL_BlitSurface(glyph, NULL, sheet, &cell);
+        atlas->src[i].w = (float)cell.w;
+        atlas->src[i].h = (float)cell.h;
+        SDL_DestroySurface(glyph);
+    }
+
+    atlas->texture = SDL_CreateTextureFromSurface(game->renderer, sheet);
+    atlas->width = (float)sheet->w;
+    atlas->height = (float)sheet->h;
+    SDL_DestroySurface(sheet);
+    if (!atlas->texture) {
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(atlas->texture, SDL_SCALEMODE_NEAREST);
+    fill_quad_indices(game->text_cache.indices, TEXT_CACHE_MAX_LEN);
+    return true;
+}
+
+void destroy_text_atlas(Game* game) {
+    if (game->text_atlas.texture) {
+        SDL_DestroyTexture(game->text_atlas.texture);
+        game->text_atlas.texture = NULL;
+    }
+}
+
+// --- Dibujo de Texto ---
+
+// Maqueta hasta max_glyphs caracteres como quads; devuelve cuántos glifos generó
+// y deja en *consumed cuántos caracteres de la cadena procesó.
+static int layout_text(const TextAtlas* atlas, const char* text, float* pen_x, float y, SDL_FColor color,
+                       SDL_Vertex* vertices, int max_glyphs, int* consumed) {
+    int glyphs = 0;
+    int n = 0;
+    for (; text[n] != '\0' && glyphs < max_glyphs; n++) {
+        int index = (unsigned char)text[n] - TEXT_FIRST_CHAR;
+        if (index < 0 || index >= TEXT_GLYPH_COUNT) {
+            index = '?' - TEXT_FIRST_CHAR;
+        }
+
+        const SDL_FRect* src = &atlas->src[index];
+        if (src->w > 0 && src->h > 0) {
+            float u0 = src->x / atlas->width;
+            float v0 = src->y / atlas->height;
+            float u1 = (src->x + src->w) / atlas->width;
+            float v1 = (src->y + src->h) / atlas->height;
+            float x0 = *pen_x, y0 = y;
+            float x1 = *pen_x + src->w, y1 = y + src->h;
+
+            SDL_Vertex* v = &vertices[glyphs * 4];
+            v[0] = (SDL_Vertex){ {x0, y0}, color, {u0, v0} };
+            v[1] = (SDL_Vertex){ {x1, y0}, color, {u1, v0} };
+            v[2] = (SDL_Vertex){ {x1, y1}, color, {u1, v1} };
+            v[3] = (SDL_Vertex){ {x0, y1}, color, {u0, v1} };
+            glyphs++;
+        }
+        *pen_x += atlas->advance[index];
+    }
+    *consumed = n;
+    return glyphs;
+}
+
+// Hash FNV-1a; devuelve también la longitud de la cadena
+static Uint32 hash_text(const char* text, size_t* length) {
+    Uint32 hash = 2166136261u;
+    size_t n = 0;
+    for (; text[n] != '\0'; n++) {
+        hash = (hash ^ (unsigned char)text[n]) * 16777619u;
+    }
+    *length = n;
+    return hash;
+}
+
+// Busca la cadena en la caché; si no está, la maqueta en la entrada menos usada
+static CachedText* lookup_cached_text(Game* game, const char* text, Uint32 hash, size_t length, int x, int y, SDL_Color color) {
+    TextCache* cache = &game->text_cache;
+    CachedText* victim = &cache->entries[0];
+
+    for (int i = 0; i < TEXT_CACHE_SIZE; i++) {
+        CachedText* entry = &cache->entries[i];
+        if (entry->valid && entry->hash == hash && entry->x == x && entry->y == y &&
+            entry->color.r == color.r && entry->color.g == color.g &&
+            entry->color.b == color.b && entry->color.a == color.a &&
+            SDL_strcmp(entry->text, text) == 0) {
+            cache->hits++;
+            entry->last_used = ++cache->use_counter;
+            return entry;
+        }
+        if (!entry->valid || (victim->valid && entry->last_used < victim->last_used)) {
+            victim = entry;
+        }
+    }
+
+    cache->misses++;
+    if (victim->valid) {
+        cache->evictions++;
+    }
+
+    SDL_FColor fcolor = { color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f };
+    float pen_x = (float)x;
+    int consumed = 0;
+    SDL_memcpy(victim->text, text, length + 1);
+    victim->hash = hash;
+    victim->x = x;
+    victim->y = y;
+    victim->color = color;
+    victim->glyph_count = layout_text(&game->text_atlas, text, &pen_x, (float)y, fcolor, victim->vertices, TEXT_CACHE_MAX_LEN, &consumed);
+    victim->last_used = ++cache->use_counter;
+    victim->valid = true;
+    return victim;
+}
+
 void draw_text(Game* game, const char* text, int x, int y, SDL_Color color) {
-    if (!game->font) return;
+    const TextAtlas* atlas = &game->text_atlas;
+    if (!atlas->texture) return;
+
+    size_t length = 0;
+    Uint32 hash = hash_text(text, &length);
 
-    SDL_Surface* surface = TTF_RenderText_Solid(game->font, text, 0, color);
-    if (surface) {
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(game->renderer, surface);
-        if (texture) {
-            SDL_FRect dest_rect = {(float)x, (float)y, (float)surface->w, (float)surface->h};
-            SDL_RenderTexture(game->renderer, texture, NULL, &dest_rect);
-            SDL_DestroyTexture(texture);
+    if (length < TEXT_CACHE_MAX_LEN) {
+        CachedText* entry = lookup_cached_text(game, text, hash, length, x, y, color);
+        if (entry->glyph_count > 0) {
+            SDL_RenderGeometry(game->renderer, atlas->texture, entry->vertices, entry->glyph_count * 4,
+                               game->text_cache.indices, entry->glyph_count * 6);
         }
-        SDL_DestroySurface(surface);
+        return;
+    }
+
+    // Cadenas largas: se maquetan en el momento, en lotes de TEXT_MAX_GLYPHS_PER_BATCH
+    SDL_Vertex vertices[TEXT_MAX_GLYPHS_PER_BATCH * 4];
+    int indices[TEXT_MAX_GLYPHS_PER_BATCH * 6];
+    SDL_FColor fcolor = { color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f };
+    float pen_x = (float)x;
+    fill_quad_indices(indices, TEXT_MAX_GLYPHS_PER_BATCH);
+    while (*text != '\0') {
+        int consumed = 0;
+        int glyphs = layout_text(atlas, text, &pen_x, (float)y, fcolor, vertices, TEXT_MAX_GLYPHS_PER_BATCH, &consumed);
+        if (glyphs > 0) {
+            SDL_RenderGeometry(game->renderer, atlas->texture, vertices, glyphs * 4, indices, glyphs * 6);
+        }
+        text += consumed;
+    }
+}
+
+// Formatea "LABEL: valor" sólo cuando el valor cambia
+const char* format_hud_value(HudValue* hud, const char* label, int value) {
+    if (!hud->valid || hud->value != value) {
+        SDL_snprintf(hud->text, sizeof(hud->text), "%s: %d", label, value);
+        hud->value = value;
+        hud->valid = true;
     }
-}
\ No newline at end of file
+    return hud->text;
+}
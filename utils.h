@@ -4,6 +4,10 @@
 #include "game.h"
 
 // --- Prototipos de Funciones de Utilidad ---
+bool init_text_atlas(Game* game);
+void destroy_text_atlas(Game* game);
+// La usa submit_render_list; los render_* graban el texto con record_text
 void draw_text(Game* game, const char* text, int x, int y, SDL_Color color);
+const char* format_hud_value(HudValue* hud, const char* label, int value);
 
-#endif // UTILS_H
\ No newline at end of file
+#endif // UTILS_H